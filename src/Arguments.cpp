@@ -1,6 +1,7 @@
 #include "Arguments.h"
 #include <string.h>
 #include <iostream>
+#include <vector>
 
 arguments::arguments(int argc, char *argv[]) {
     argInt = 0;
@@ -8,6 +9,9 @@ arguments::arguments(int argc, char *argv[]) {
     if (args["file"]) {
         argStr = getFileName(argc, argv);
     }
+    if (args["mask"]) {
+        argStr = values["mask"].empty() ? "404" : values["mask"];
+    }
     if (args["filled"] || args["empty"]) {
         argInt = getInt(argc, argv);
         if (args["filled"] && argInt != 0) {
@@ -30,7 +34,16 @@ bool arguments::printHelp() {
                            "-s --solve\t\tSolve a sudoku puzzle.\n"
                            "-f --file\t\tRead or write to a file. Requires a file name.\n"
                            "-e --empty\t\tNumber of empty squares in board. Requires a number.\n\t\t\tCannot be used with -F.\n"
-                           "-F --filled\t\tNumber of filled squares in board. Requires a number.\n\t\t\tCannot be used with -e.\n\n"
+                           "-F --filled\t\tNumber of filled squares in board. Requires a number.\n\t\t\tCannot be used with -e.\n"
+                           "-m --minimal\t\tGenerate a minimal puzzle where every clue is necessary.\n\t\t\tCannot be used with -e or -F.\n"
+                           "-M --mask\t\tGenerate a puzzle with clues in the given positions.\n\t\t\tRequires a mask or a file containing one.\n"
+                           "-D --db\t\t\tPlay from or generate into a puzzle database.\n\t\t\tRequires a file name.\n"
+                           "-n --count\t\tNumber of puzzles to generate into the database.\n"
+                           "-t --tier\t\tDifficulty tier of the puzzle to play from the database.\n"
+                           "-G --grade\t\tGrade every puzzle in a file. Requires a file name,\n\t\t\t'-' reads one puzzle per line from standard input.\n"
+                           "-j --jobs\t\tNumber of threads to grade with. Defaults to every core.\n"
+                           "--json\t\t\tPrint the grades as JSON lines instead of CSV.\n"
+                           "--all-singles\t\tPlace every single at once when grading.\n\n"
                            "Configuration is done by editing the file config.h\n"
                            "That file also contains all the keybinds.\n\n"
                            "Play\n"
@@ -48,7 +61,29 @@ bool arguments::printHelp() {
                            "along with the file name to save to. Pass '-e' or '--empty' to"
                            "specify the number of empty squares OR '-F' or '--filled' to\n"
                            "specify the number of squares to fill in. Be aware that generating\n"
-                           "difficult puzzles may take a very long time.\n\n"
+                           "difficult puzzles may take a very long time. Puzzles with more than 58\n"
+                           "empty squares are searched for for up to a minute, after which the\n"
+                           "emptiest puzzle found is used. Pass '-m' or '--minimal'\n"
+                           "to keep removing squares until every remaining clue is needed for\n"
+                           "the solution to be unique.\n"
+                           "Pass '-M' or '--mask' along with 81 characters, or a file containing\n"
+                           "them, to choose where the clues go. 'X' or a digit marks a clue and\n"
+                           "'.' or '0' marks an empty square, like a line of an SDM file.\n\n"
+                           "Database\n"
+                           "Pass '-D' or '--db' along with a file name to keep puzzles in a database.\n"
+                           "When generating, '-n' or '--count' puzzles are graded and added to it,\n"
+                           "skipping puzzles that are already in it. When playing, a random puzzle\n"
+                           "is picked from it. Use '-t' or '--tier' to choose the difficulty and\n"
+                           "'-e' or '-F' to choose the number of empty or filled squares.\n\n"
+                           "Grade\n"
+                           "Pass '-G' or '--grade' along with a file name to grade every puzzle in it\n"
+                           "with the human solver on '-j' or '--jobs' threads. The tier, number of\n"
+                           "moves and if the solver finished are printed for every puzzle as CSV,\n"
+                           "or as JSON lines with '--json'. A histogram of the tiers is printed to\n"
+                           "standard error afterwards. Grading '-' reads puzzles from standard input,\n"
+                           "one per line, and grades them as they come in. '--all-singles' is faster,\n"
+                           "every naked single, or every hidden single when there are no naked ones,\n"
+                           "is placed in one step. Puzzles that naked singles solve then get tier 1.\n\n"
                            "Solve\n"
                            "To solve a puzzle pass '-s' or '--solve' to input a puzzle to generate.\n"
                            "The puzzle will automatically be solved once a unique solution is found.\n"
@@ -68,6 +103,7 @@ std::map<std::string, bool> arguments::parse(int argc, char *argv[]) {
 
         if (argv[i][0] == '-' && argv[i][1] != '-') {
             // Single letter arguments, loop through every letter
+            std::vector<std::string> needValue;
             for (size_t j = 1; j < strlen(argv[i]); j++) {
                 char c = argv[i][j];
                 switch(c) {
@@ -95,8 +131,38 @@ std::map<std::string, bool> arguments::parse(int argc, char *argv[]) {
                     case 'b':
                     args["big"] = true;
                     break;
+                    case 'm':
+                    args["minimal"] = true;
+                    break;
+                    case 'M':
+                    args["mask"] = true;
+                    needValue.push_back("mask");
+                    break;
+                    case 'D':
+                    args["db"] = true;
+                    needValue.push_back("db");
+                    break;
+                    case 'n':
+                    args["count"] = true;
+                    needValue.push_back("count");
+                    break;
+                    case 't':
+                    args["tier"] = true;
+                    needValue.push_back("tier");
+                    break;
+                    case 'G':
+                    args["grade"] = true;
+                    needValue.push_back("grade");
+                    break;
+                    case 'j':
+                    args["jobs"] = true;
+                    needValue.push_back("jobs");
+                    break;
                 }
             }
+            for (auto &name : needValue) {
+                takeValue(name, i, argc, argv);
+            }
         }
 
         else if (argv[i][0] == '-' && argv[i][1] == '-') {
@@ -125,17 +191,70 @@ std::map<std::string, bool> arguments::parse(int argc, char *argv[]) {
             else if (strcmp(argv[i]+2, "big") == 0) {
                 args["big"] = true;
             }
+            else if (strcmp(argv[i]+2, "minimal") == 0) {
+                args["minimal"] = true;
+            }
+            else if (strcmp(argv[i]+2, "mask") == 0) {
+                args["mask"] = true;
+                takeValue("mask", i, argc, argv);
+            }
+            else if (strcmp(argv[i]+2, "db") == 0) {
+                args["db"] = true;
+                takeValue("db", i, argc, argv);
+            }
+            else if (strcmp(argv[i]+2, "count") == 0) {
+                args["count"] = true;
+                takeValue("count", i, argc, argv);
+            }
+            else if (strcmp(argv[i]+2, "tier") == 0) {
+                args["tier"] = true;
+                takeValue("tier", i, argc, argv);
+            }
+            else if (strcmp(argv[i]+2, "grade") == 0) {
+                args["grade"] = true;
+                takeValue("grade", i, argc, argv);
+            }
+            else if (strcmp(argv[i]+2, "jobs") == 0) {
+                args["jobs"] = true;
+                takeValue("jobs", i, argc, argv);
+            }
+            else if (strcmp(argv[i]+2, "json") == 0) {
+                args["json"] = true;
+            }
+            else if (strcmp(argv[i]+2, "all-singles") == 0) {
+                args["all-singles"] = true;
+            }
         }
     }
-    if (!args["generate"] && !args["solve"]) {
+    if (args["mask"]) {
+        args["generate"] = true;
+    }
+    if (!args["generate"] && !args["solve"] && !args["grade"]) {
         args["play"] = true;
     }
     return args;
 }
 
+/**
+ * @brief Uses the argument after i as the value of an option
+ * 
+ * The value is skipped when looking for the file name and number.
+ * 
+ * @param name of the option
+ * @param i index of the option, moved to the value
+ */
+void arguments::takeValue(const std::string &name, int &i, int argc, char *argv[]) {
+    if (i + 1 >= argc) {
+        return;
+    }
+    i++;
+    values[name] = argv[i];
+    consumed.insert(i);
+}
+
 std::string arguments::getFileName(int argc, char *argv[]) {
     for (auto i = 1; i < argc; i++) {
-        if (argv[i][0] == '-')
+        if (argv[i][0] == '-' || consumed.count(i) != 0)
             continue;
         
         if (atoi(argv[i]) == 0) {
@@ -147,7 +266,7 @@ std::string arguments::getFileName(int argc, char *argv[]) {
 
 int arguments::getInt(int argc, char *argv[]) {
     for (auto i = 1; i < argc; i++) {
-        if (argv[i][0] == '-')
+        if (argv[i][0] == '-' || consumed.count(i) != 0)
             continue;
         int ret = atoi(argv[i]);
         if (ret > 0 && ret <= 81)
@@ -157,8 +276,19 @@ int arguments::getInt(int argc, char *argv[]) {
 }
 
 bool arguments::incompatible(std::map<std::string, bool> args) {
-    if ((args["generate"] && args["solve"]) || (args["generate"] && args["play"]) || (args["solve"] && args["play"])) {
-        std::cout << "Incompatible arguments supplied.\nEither generate, solve, or play.\n";
+    if ((args["generate"] && args["solve"]) || (args["generate"] && args["play"]) || (args["solve"] && args["play"])
+        || (args["grade"] && (args["generate"] || args["solve"] || args["play"]))) {
+        std::cout << "Incompatible arguments supplied.\nEither generate, solve, play or grade.\n";
+        return true;
+    }
+
+    if (args["grade"] && (args["file"] || args["db"] || args["empty"] || args["filled"] || args["minimal"] || args["big"])) {
+        std::cout << "Grading only reads the puzzles from the file it is given.\n";
+        return true;
+    }
+
+    if ((args["jobs"] || args["json"] || args["all-singles"]) && !args["grade"]) {
+        std::cout << "The number of jobs, JSON output and placing all singles can only be given when grading.\n";
         return true;
     }
 
@@ -171,6 +301,26 @@ bool arguments::incompatible(std::map<std::string, bool> args) {
         std::cout << "Either supply the number of empty or the number of filled boxes. Not both.\n";
         return true;
     }
+
+    if (args["mask"] && (args["file"] || args["minimal"] || args["empty"] || args["filled"])) {
+        std::cout << "The mask decides the empty boxes and is printed instead of saved.\n";
+        return true;
+    }
+
+    if (args["db"] && (args["solve"] || args["file"] || args["mask"])) {
+        std::cout << "A database can only be generated into or played from.\n";
+        return true;
+    }
+
+    if ((args["count"] && !(args["db"] && args["generate"])) || (args["tier"] && !(args["db"] && args["play"]))) {
+        std::cout << "A count can only be given when generating into a database and a tier when playing from one.\n";
+        return true;
+    }
+
+    if (args["minimal"] && (args["solve"] || args["empty"] || args["filled"])) {
+        std::cout << "Minimal puzzles can only be generated or played and decide their own number of empty boxes.\n";
+        return true;
+    }
     return false;
 }
 
@@ -179,6 +329,22 @@ bool arguments::shouldExit() {
         std::cout << "No filed name supplied.\n";
         return true;
     }
+    if (args["mask"] && argStr == "404") {
+        std::cout << "No mask supplied.\n";
+        return true;
+    }
+    if (args["db"] && values["db"].empty()) {
+        std::cout << "No database supplied.\n";
+        return true;
+    }
+    if (args["grade"] && values["grade"].empty()) {
+        std::cout << "No filed name supplied.\n";
+        return true;
+    }
+    if ((args["count"] && getCount() <= 0) || (args["tier"] && getTier() < 0) || (args["jobs"] && getJobs() <= 0)) {
+        std::cout << "No number supplied.\n";
+        return true;
+    }
     if ((args["empty"] || args["filled"]) && argInt == 0) {
         std::cout << "No number supplied.\n";
         return true;
@@ -187,6 +353,9 @@ bool arguments::shouldExit() {
 }
 
 feature arguments::getFeature() {
+    if (args["grade"]) {
+        return feature::Grading;
+    }
     if (args["solve"]) {
         return feature::Solve;
     }
@@ -210,4 +379,55 @@ bool arguments::fileArgSet() {
 
 bool arguments::bigBoard() {
     return args["big"];
-}
\ No newline at end of file
+}
+
+bool arguments::minimal() {
+    return args["minimal"];
+}
+
+bool arguments::maskArgSet() {
+    return args["mask"];
+}
+
+bool arguments::databaseArgSet() {
+    return args["db"];
+}
+
+std::string arguments::getDatabase() {
+    return values["db"];
+}
+
+int arguments::getCount() {
+    if (!args["count"]) {
+        return 1;
+    }
+    return atoi(values["count"].c_str());
+}
+
+int arguments::getTier() {
+    if (!args["tier"] || values["tier"].empty()) {
+        return -1;
+    }
+    return atoi(values["tier"].c_str());
+}
+std::string arguments::getGradeFile() {
+    return values["grade"];
+}
+
+/**
+ * @brief Gets the number of threads to grade with, 0 if not given
+ */
+int arguments::getJobs() {
+    if (!args["jobs"]) {
+        return 0;
+    }
+    return atoi(values["jobs"].c_str());
+}
+
+bool arguments::json() {
+    return args["json"];
+}
+
+bool arguments::allSingles() {
+    return args["all-singles"];
+}
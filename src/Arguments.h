@@ -1,11 +1,13 @@
 #pragma once
 #include <map>
+#include <set>
 #include <string>
 
 enum feature {
     Generate,
     Solve,
     Play,
+    Grading,
 };
 
 class arguments {
@@ -14,7 +16,10 @@ class arguments {
     std::string argStr;
 
     std::map<std::string, bool> args;
+    std::map<std::string, std::string> values;
+    std::set<int> consumed;
     std::map<std::string, bool> parse(int argc, char *argv[]);
+    void takeValue(const std::string &name, int &i, int argc, char *argv[]);
     std::string getFileName(int argc, char *argv[]);
     int getInt(int argc, char *argv[]);
     bool incompatible(std::map<std::string, bool> args);
@@ -28,4 +33,14 @@ class arguments {
     std::string getFileName();
     bool fileArgSet();
     bool bigBoard();
+    bool minimal();
+    bool maskArgSet();
+    bool databaseArgSet();
+    std::string getDatabase();
+    int getCount();
+    int getTier();
+    std::string getGradeFile();
+    int getJobs();
+    bool json();
+    bool allSingles();
 };
\ No newline at end of file
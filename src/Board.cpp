@@ -1,5 +1,6 @@
 #include "Board.h"
 #include "config.h"
+#include "Zobrist.h"
 #include <iostream>
 #include <sstream>
 
@@ -86,69 +87,150 @@ Board::Board(Sudoku::puzzle startGrid,
              Sudoku::puzzle finishGrid
             ) : SimpleBoard(startGrid),
                 startGrid(startGrid), 
-                solutionGrid(finishGrid) {
+                solutionGrid(finishGrid),
+                solved(true) {
     pencilMarks = {};
-    for (auto i = 1; i <= 9; i++) {
-        count.insert({i, 0});
-    }
-
-    for (auto i = 0; i < 9; i++) {
-        for (auto j = 0; j < 9; j++) {
-            int val = startGrid[i][j];
-            if (val != 0) {
-                count[val]++;
-            }
-        }
-    }
+    positions = {};
+    history = {};
+    countSquares();
 }
 
 Board::Board(Sudoku::puzzle startGrid) : SimpleBoard(startGrid), startGrid(startGrid) {
     pencilMarks = {};
-    solutionGrid = startGrid;
-    Sudoku::solve(solutionGrid);
+    positions = {};
+    solved = false;
 
-    for (auto i = 1; i <= 9; i++) {
-        count.insert({i, 0});
-    }
+    history = {};
+    countSquares();
+}
+
+Board::Board(std::string gridString) : SimpleBoard(gridString) {
+    pencilMarks = {};
+    positions = {};
+    startGrid = playGrid;
+    solved = false;
+
+    history = {};
+    countSquares();
+}
 
+/**
+ * @brief Counts the digits, filled and correct squares from scratch
+ */
+void Board::countSquares() {
+    count = {};
+    filled = 0;
+    gridHash = 0;
+    hash = 0;
     for (auto i = 0; i < 9; i++) {
         for (auto j = 0; j < 9; j++) {
-            int val = startGrid[i][j];
+            int val = playGrid[i][j];
+            int cell = i * Sudoku::SIZE + j;
             if (val != 0) {
                 count[val]++;
+                filled++;
+                gridHash ^= Zobrist::DIGITS[cell][val - 1];
+            }
+            std::uint16_t marks = indexedMarks(i, j);
+            for (auto digit = 0; digit < 9; digit++) {
+                if (marks & (1 << digit)) {
+                    hash ^= Zobrist::MARKS[cell][digit];
+                }
             }
         }
     }
-}
-
-Board::Board(std::string gridString) : SimpleBoard(gridString) {
-    startGrid = playGrid;
-    solutionGrid = playGrid;
-    Sudoku::solve(solutionGrid);
-
-    for (auto i = 1; i <= 9; i++) {
-        count.insert({i, 0});
+    hash ^= gridHash;
+    for (auto unit = 0; unit < 27; unit++) {
+        countUnit(unit);
+    }
+    if (solved) {
+        countCorrect();
     }
+}
 
+/**
+ * @brief Counts the squares that match the solution from scratch
+ */
+void Board::countCorrect() const{
+    correct = 0;
     for (auto i = 0; i < 9; i++) {
         for (auto j = 0; j < 9; j++) {
-            int val = startGrid[i][j];
-            if (val != 0) {
-                count[val]++;
+            if (playGrid[i][j] == solutionGrid[i][j]) {
+                correct++;
             }
         }
     }
 }
 
+/**
+ * @brief Finds the digits of a unit and the ones that are in it more than once
+ */
+void Board::countUnit(int unit) {
+    std::uint16_t digits = 0;
+    std::uint16_t duplicates = 0;
+    for (auto cell : Sudoku::UNIT_CELLS[unit]) {
+        int val = playGrid[Sudoku::ROW_OF[cell]][Sudoku::COL_OF[cell]];
+        if (val == 0) continue;
+        std::uint16_t bit = 1u << (val - 1);
+        duplicates |= digits & bit;
+        digits |= bit;
+    }
+    unitDigits[unit] = digits;
+    unitDuplicates[unit] = duplicates;
+}
+
+/**
+ * @brief Puts a digit in a square and keeps the counts up to date
+ * 
+ * @param val digit, 0 to empty the square
+ */
+void Board::place(int row, int col, int val) {
+    int old = playGrid[row][col];
+    if (old == val) {
+        return;
+    }
+    if (old != 0) {
+        count[old]--;
+        filled--;
+    }
+    if (val != 0) {
+        count[val]++;
+        filled++;
+    }
+    if (solved && old == solutionGrid[row][col]) {
+        correct--;
+    }
+    if (solved && val == solutionGrid[row][col]) {
+        correct++;
+    }
+    int cell = row * Sudoku::SIZE + col;
+    std::uint64_t keys = (old != 0 ? Zobrist::DIGITS[cell][old - 1] : 0) ^ (val != 0 ? Zobrist::DIGITS[cell][val - 1] : 0);
+    gridHash ^= keys;
+    hash ^= keys;
+    playGrid[row][col] = val;
+    for (auto unit : Sudoku::CELL_UNITS[cell]) {
+        countUnit(unit);
+    }
+}
+
+/**
+ * @brief Checks if the board is solved, and stops playing if it is
+ * 
+ * Only needs the solution once every square is filled.
+ */
 bool Board::isWon(){
-    if (playGrid == solutionGrid) {
+    if (filled < Sudoku::CELLS) {
+        return false;
+    }
+    getSolution();
+    if (correct == Sudoku::CELLS) {
         playing = false;
         return true;
     }
     return false;
 }
 
-const std::array<std::array<std::uint16_t, 9>, 9> &Board::getPencilMarks() {
+const Board::markTable &Board::getPencilMarks() const {
     return pencilMarks;
 }
 
@@ -156,7 +238,19 @@ const Sudoku::puzzle &Board::getStartGrid() const{
     return startGrid;
 }
 
+/**
+ * @brief Gets the solution, solving the start grid the first time
+ * 
+ * Boards made without a solution don't solve before it's needed, so
+ * opening or grading puzzles doesn't pay for a solve up front.
+ */
 const Sudoku::puzzle &Board::getSolution() const{
+    if (!solved) {
+        solutionGrid = startGrid;
+        Sudoku::solve(solutionGrid);
+        solved = true;
+        countCorrect();
+    }
     return solutionGrid;
 }
 
@@ -168,8 +262,8 @@ bool Board::insert(char val, int row, int col) {
 
     if (val == ERASE_KEY || START_CHAR - 1 == val) {
         if (playGrid[row][col] != 0) {
-            count[playGrid[row][col]]--;
-            playGrid[row][col] = 0;
+            place(row, col, 0);
+            updatePositions(row, col, 0);
             restoreMarks(row, col);
             return true;
         }
@@ -178,115 +272,256 @@ bool Board::insert(char val, int row, int col) {
 
     if (val > START_CHAR - 1 && val <= START_CHAR + 8) {
         restoreMarks(row, col);
-        if (playGrid[row][col] != 0)
-            count[playGrid[row][col]]--;
-        count[val - '0']++;
-        playGrid[row][col] = val - START_CHAR + 1;
+        std::uint16_t before = indexedMarks(row, col);
+        place(row, col, val - START_CHAR + 1);
+        updatePositions(row, col, before);
     }
 
     removeMarks(val, row, col);
-    return playGrid[row][col] == solutionGrid[row][col];
+    return playGrid[row][col] == getSolution()[row][col];
 }
 
+/**
+ * @brief Pencils in every digit that isn't in a peer of each empty square
+ * 
+ * The candidates of a square are the digits missing from the digits kept
+ * for its three units, no peers are read.
+ */
 void Board::autoPencil() {
-    for (size_t i = 0; i < playGrid.size(); i++) {
-        for (size_t j = 0; j < playGrid[i].size(); j++) {
-            if (playGrid[i][j] > 0) {
-                // Number is filled, don't put pencil marks
-                continue;
-            }
-            auto &marks = pencilMarks[i][j];
-            marks = 0;
-            for (unsigned char k = START_CHAR; k < START_CHAR + 9; k++) {
-                if (Sudoku::isSafe(playGrid, i, j, k - START_CHAR + 1)) {
-                    marks |= (1 << (k - START_CHAR));
-                }
-            }
+    for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+        int row = Sudoku::ROW_OF[cell];
+        int col = Sudoku::COL_OF[cell];
+        if (playGrid[row][col] > 0) {
+            // Number is filled, don't put pencil marks
+            continue;
         }
+        const auto &units = Sudoku::CELL_UNITS[cell];
+        std::uint16_t before = pencilMarks[cell];
+        std::uint16_t placed = unitDigits[units[0]] | unitDigits[units[1]] | unitDigits[units[2]];
+        pencilMarks[cell] = ~placed & ((1u << 9) - 1);
+        updatePositions(row, col, before);
     }
 }
 
+/**
+ * @brief Sets the digit and pencil marks of a square as they are
+ * 
+ * The peers are left alone and nothing is remembered for restoreMarks,
+ * it's used to step back and forth through a journal of changes.
+ * 
+ * @param row of the square
+ * @param col of the square
+ * @param val digit, 0 for empty
+ * @param marks pencil marks of the square
+ */
+void Board::setSquare(int row, int col, int val, std::uint16_t marks) {
+    if (startGrid[row][col] != 0) {
+        return;
+    }
+    std::uint16_t before = indexedMarks(row, col);
+    if (playGrid[row][col] != val) {
+        place(row, col, val);
+        history[row * Sudoku::SIZE + col] = {};
+    }
+    pencilMarks[row * Sudoku::SIZE + col] = marks;
+    updatePositions(row, col, before);
+}
+
+/**
+ * @brief Puts a whole grid on the board in one pass
+ * 
+ * Clues are kept, every other square gets the digit of the grid. Like
+ * insert, the pencil marks of a digit are removed from its square and
+ * its peers, filled or not. The counts, position table and hashes are
+ * built again once instead of following every square.
+ * 
+ * @param grid digits to put on the board, 0 for empty
+ */
+void Board::assign(const Sudoku::puzzle &grid) {
+    for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+        int row = Sudoku::ROW_OF[cell];
+        int col = Sudoku::COL_OF[cell];
+        if (startGrid[row][col] == 0) {
+            playGrid[row][col] = grid[row][col];
+        }
+    }
+    for (auto unit = 0; unit < 27; unit++) {
+        countUnit(unit);
+    }
+    history = {};
+    positions = {};
+    for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+        int row = Sudoku::ROW_OF[cell];
+        int col = Sudoku::COL_OF[cell];
+        // filled squares too, insert takes a digit's mark from the square
+        // it's put in and from filled peers
+        const auto &units = Sudoku::CELL_UNITS[cell];
+        if (REMOVE_MARKS) {
+            pencilMarks[cell] &= ~(unitDigits[units[0]] | unitDigits[units[1]] | unitDigits[units[2]]);
+        }
+        if (isEmpty(row, col)) {
+            updatePositions(row, col, 0);
+        }
+    }
+    countSquares();
+}
+
 bool Board::pencil(const char val, int row, int col) {
     if (playGrid[row][col] > 0) {
         // Grid not empty, cant pencil here
         return false;
     }
+    std::uint16_t before = pencilMarks[row * Sudoku::SIZE + col];
     if (val == ERASE_KEY || START_CHAR - 1 == val) {
-        pencilMarks[row][col] = 0;
+        pencilMarks[row * Sudoku::SIZE + col] = 0;
+        updatePositions(row, col, before);
         return true;
     }
 
     // toggle the bit
     bool ret = true;
-    if (((pencilMarks[row][col] & (1 << (val - START_CHAR)))) == 0) {
+    if (((pencilMarks[row * Sudoku::SIZE + col] & (1 << (val - START_CHAR)))) == 0) {
         ret = true;
     }
-    else if (solutionGrid[row][col] == (val - START_CHAR) + 1) {
+    else if (getSolution()[row][col] == (val - START_CHAR) + 1) {
         ret = false;
     }
-    pencilMarks[row][col] ^= (1 << (val - START_CHAR));
+    pencilMarks[row * Sudoku::SIZE + col] ^= (1 << (val - START_CHAR));
+    updatePositions(row, col, before);
     return ret;
 }
 
 std::uint16_t Board::getPencil(char row, char col) const{
-    return pencilMarks[row][col];
+    return pencilMarks[row * Sudoku::SIZE + col];
 }
 
-void Board::removeMarks(char val, int row, int col) {
-    if (!REMOVE_MARKS)
+/**
+ * @brief Gets the table of where every digit is pencilled in each unit
+ * 
+ * Rows start at ROW_UNIT, columns at COL_UNIT and boxes at BOX_UNIT. A
+ * row has the bit of each column set, a column the bit of each row and a
+ * box bit (row % 3) * 3 + col % 3. Filled squares are never set.
+ * 
+ * @return table indexed by unit and digit - 1
+ */
+const std::array<std::array<std::uint16_t, 9>, 27> &Board::getPositions() const{
+    return positions;
+}
+
+/**
+ * @brief Gets where a digit is pencilled in a unit
+ * 
+ * @param unit index of the unit, see getPositions
+ * @param digit digit - 1
+ * @return std::uint16_t positions in the unit as set bits
+ */
+std::uint16_t Board::getPositions(int unit, int digit) const{
+    return positions[unit][digit];
+}
+
+/**
+ * @brief The pencil marks of a square as far as the position table is concerned
+ */
+std::uint16_t Board::indexedMarks(int row, int col) const{
+    return isEmpty(row, col) ? pencilMarks[row * Sudoku::SIZE + col] : 0;
+}
+
+/**
+ * @brief Updates the position table and the hash after a square changed
+ * 
+ * @param row of the square
+ * @param col of the square
+ * @param before what indexedMarks returned before the change
+ */
+void Board::updatePositions(int row, int col, std::uint16_t before) {
+    std::uint16_t changed = before ^ indexedMarks(row, col);
+    if (changed == 0) {
         return;
-    for (auto i = 0; i < 9; i++) {
-       pencilMarks[row][i] &= ~(1u << (val - START_CHAR));
-       pencilMarks[i][col] &= ~(1u << (val - START_CHAR));
     }
-
-    int boxRow = (row / 3) * 3;
-    int boxCol = (col / 3) * 3;
-    for (auto i = boxRow; i < boxRow + 3; i++) {
-        for (auto j = boxCol; j < boxCol + 3; j++) {
-            auto &mark = pencilMarks[i][j];
-            mark &= ~(1u << (val - START_CHAR));
+    int cell = row * Sudoku::SIZE + col;
+    const auto &units = Sudoku::CELL_UNITS[cell];
+    const auto &inUnits = Sudoku::UNIT_POSITIONS[cell];
+    for (auto digit = 0; digit < 9; digit++) {
+        if ((changed & (1 << digit)) == 0) continue;
+        for (auto i = 0; i < 3; i++) {
+            positions[units[i]][digit] ^= (1 << inUnits[i]);
         }
+        hash ^= Zobrist::MARKS[cell][digit];
+    }
+}
+
+/**
+ * @brief Removes the pencil marks of val from a square and its peers
+ * 
+ * Remembers which marks were removed so restoreMarks can put them back.
+ */
+void Board::removeMarks(char val, int row, int col) {
+    if (!REMOVE_MARKS || val < START_CHAR || val > START_CHAR + 8)
+        return;
+    int source = row * Sudoku::SIZE + col;
+    std::uint16_t bit = 1u << (val - START_CHAR);
+    std::uint32_t squares = 0;
+    auto clear = [&](int cell, int index) {
+        auto &marks = pencilMarks[cell];
+        if ((marks & bit) == 0) return;
+        std::uint16_t before = indexedMarks(Sudoku::ROW_OF[cell], Sudoku::COL_OF[cell]);
+        marks &= ~bit;
+        updatePositions(Sudoku::ROW_OF[cell], Sudoku::COL_OF[cell], before);
+        squares |= 1u << index;
+    };
+    clear(source, Sudoku::PEER_COUNT);
+    for (auto i = 0; i < Sudoku::PEER_COUNT; i++) {
+        clear(Sudoku::PEERS[source][i], i);
     }
+    history[source] = {squares, (std::uint32_t)(val - START_CHAR)};
 }
 
+/**
+ * @brief Puts back the pencil marks removed by the digit in a square
+ * 
+ * A mark isn't put back in a square that has been filled since or that sees
+ * the digit somewhere else.
+ */
 void Board::restoreMarks(int row, int col) {
-    for (auto i = 0; i < 9; i++) {
-        if (pencilHistory[row][i][cell{row, col}]) {
-            pencil(pencilHistory[row][i][cell{row, col}], row, i);
-            pencilHistory[row][i][cell{row, col}] = 0;
+    int source = row * Sudoku::SIZE + col;
+    auto &removed = history[source];
+    std::uint16_t bit = 1u << removed.val;
+    auto restore = [&](int cell) {
+        if (cell != source && playGrid[Sudoku::ROW_OF[cell]][Sudoku::COL_OF[cell]] != 0) {
+            return;
         }
-        if (pencilHistory[i][col][cell{row, col}]) {
-            pencil(pencilHistory[i][col][cell{row, col}], i, col);
-            pencilHistory[i][col][cell{row, col}] = 0;
+        for (auto peer : Sudoku::PEERS[cell]) {
+            if (peer != source && playGrid[Sudoku::ROW_OF[peer]][Sudoku::COL_OF[peer]] == (int)removed.val + 1) {
+                return;
+            }
         }
+        std::uint16_t before = indexedMarks(Sudoku::ROW_OF[cell], Sudoku::COL_OF[cell]);
+        pencilMarks[cell] |= bit;
+        updatePositions(Sudoku::ROW_OF[cell], Sudoku::COL_OF[cell], before);
+    };
+    if (removed.squares & (1u << Sudoku::PEER_COUNT)) {
+        restore(source);
     }
-    int boxRow = (row / 3) * 3;
-    int boxCol = (col / 3) * 3;
-    for (auto i = boxRow; i < boxRow + 3; i++) {
-        for (auto j = boxCol; j < boxCol + 3; j++){
-            if (pencilHistory[i][j][cell{row, col}]) {
-                pencil(pencilHistory[i][j][cell{row, col}], i, j);
-                pencilHistory[i][j][cell{row, col}] = 0;
-            }
+    for (auto i = 0; i < Sudoku::PEER_COUNT; i++) {
+        if (removed.squares & (1u << i)) {
+            restore(Sudoku::PEERS[source][i]);
         }
     }
-
+    removed = {};
 }
 
 bool Board::isRemaining(char val) const{
     if (val == 0)
         return true;
-    //return count[val] < 9;
-    return count.at(val) < 9;
+    return count[val] < 9;
 }
 
 void Board::printSolution() const{
-    printBoard(solutionGrid, std::cout);
+    printBoard(getSolution(), std::cout);
 }
 
 void Board::printSolution(std::ostream &stream) const{
-    printBoard(solutionGrid, stream);
+    printBoard(getSolution(), stream);
 }
 
 void Board::printStart() const{
@@ -304,4 +539,91 @@ void Board::swapStartGrid(){
 void Board::swapStartGrid(Sudoku::puzzle solution){
     startGrid = playGrid;
     solutionGrid = solution;
-}
\ No newline at end of file
+    solved = true;
+    countSquares();
+}
+
+/**
+ * @brief Checks if the digit in a square is the one in the solution
+ */
+bool Board::isCorrect(int row, int col) const{
+    return playGrid[row][col] == getSolution()[row][col];
+}
+
+/**
+ * @brief Checks if the digit in a square is also in one of its peers
+ */
+bool Board::isConflict(int row, int col) const{
+    int val = playGrid[row][col];
+    if (val == 0) {
+        return false;
+    }
+    for (auto unit : Sudoku::CELL_UNITS[row * Sudoku::SIZE + col]) {
+        if (unitDuplicates[unit] & (1u << (val - 1))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks if every square is filled and no unit has a digit twice
+ * 
+ * Such a board is a solution of the puzzle, found without solving it.
+ */
+bool Board::isComplete() const{
+    if (filled < Sudoku::CELLS) {
+        return false;
+    }
+    for (auto duplicates : unitDuplicates) {
+        if (duplicates != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if a digit can go in a square without being in a peer
+ * 
+ * @param digit 1 to 9, anything else is always safe
+ * @param row of the square
+ * @param col of the square
+ */
+bool Board::isSafe(int digit, int row, int col) const{
+    if (digit < 1 || digit > 9) {
+        return true;
+    }
+    std::uint16_t bit = 1u << (digit - 1);
+    bool self = playGrid[row][col] == digit;
+    for (auto unit : Sudoku::CELL_UNITS[row * Sudoku::SIZE + col]) {
+        if ((unitDigits[unit] & bit) && (!self || (unitDuplicates[unit] & bit))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the number of filled squares, clues included
+ */
+int Board::getFilled() const{
+    return filled;
+}
+
+/**
+ * @brief Gets the hash of the digits and the pencil marks of the empty squares
+ * 
+ * Kept up to date with every change, positions the human solver sees as
+ * the same have the same hash.
+ */
+std::uint64_t Board::getHash() const{
+    return hash;
+}
+
+/**
+ * @brief Gets the hash of the digits on the board, pencil marks left out
+ */
+std::uint64_t Board::getGridHash() const{
+    return gridHash;
+}
@@ -1,23 +1,14 @@
 #pragma once
 #include <array>
 #include <vector>
-#include <map>
 #include <iosfwd>
 #include <cstdint>
+#include <type_traits>
 #include "Sudoku/Sudoku.h"
+#include "Sudoku/Units.h"
 
 class SimpleBoard {
     protected:
-        struct cell {
-            int row:5;
-            int col:5;
-            bool operator<(const cell &r) const {
-                return (row < r.row || (row == r.row && col < r.col));
-            }
-            bool operator==(const cell &r) const {
-                return row == r.row && col == r.col;
-            }
-        };
         Sudoku::puzzle playGrid;
         bool playing;
         void printBoard(Sudoku::puzzle grid, std::ostream &stream) const;
@@ -32,40 +23,96 @@ class SimpleBoard {
 
         const Sudoku::puzzle &getPlayGrid() const;
 
-        virtual bool insert(char val, int row, int col);
+        bool insert(char val, int row, int col);
 
         void printBoard(std::ostream &stream) const;
         void printBoard() const;
 };
 
 class Board : public SimpleBoard {
+    public:
+        // pencil marks of every square in row order
+        typedef std::array<std::uint16_t, Sudoku::CELLS> markTable;
+
     private:
         Sudoku::puzzle startGrid;
-        Sudoku::puzzle solutionGrid;
+        // Only solved when first needed, see getSolution
+        mutable Sudoku::puzzle solutionGrid;
+        mutable bool solved;
 
-        std::array<std::array<std::uint16_t, 9>, 9> pencilMarks;
-        std::array<std::array<std::map<cell, char>, 9>, 9> pencilHistory;
+        // square n is row n / 9, column n % 9, read a register at a time
+        // by Candidates
+        alignas(32) markTable pencilMarks;
 
-        std::map<char, char> count;
+        /**
+         * @brief Pencil marks a filled square removed
+         * 
+         * Bit i of squares is set when the mark of val was removed from
+         * PEERS[square][i], bit PEER_COUNT when it was removed from the
+         * square itself.
+         */
+        struct removedMarks {
+            std::uint32_t squares : Sudoku::PEER_COUNT + 1;
+            std::uint32_t val : 4;
+        };
+        std::array<removedMarks, Sudoku::CELLS> history;
 
+        // number of times every digit is on the board, indexed by the digit
+        std::array<std::uint8_t, 10> count;
+        std::uint8_t filled;
+        // squares that match the solution, the game is won at 81. Only
+        // counted once the solution is known
+        mutable std::uint8_t correct;
+        // digits in each unit and the digits that are in it more than once
+        std::array<std::uint16_t, 27> unitDigits;
+        std::array<std::uint16_t, 27> unitDuplicates;
+        // Zobrist hashes, see getHash
+        std::uint64_t hash;
+        std::uint64_t gridHash;
+
+        // positions[unit][digit] has a bit set for every empty cell in the unit with the digit pencilled in
+        std::array<std::array<std::uint16_t, 9>, 27> positions;
+
+        void countSquares();
+        void countCorrect() const;
+        void countUnit(int unit);
+        void place(int row, int col, int val);
         void removeMarks(char val, int row, int col);
         void restoreMarks(int row, int col);
+        std::uint16_t indexedMarks(int row, int col) const;
+        void updatePositions(int row, int col, std::uint16_t before);
 
     public:
+        // Offsets of each kind of unit in the position table
+        static const int ROW_UNIT = Sudoku::ROW_UNIT;
+        static const int COL_UNIT = Sudoku::COL_UNIT;
+        static const int BOX_UNIT = Sudoku::BOX_UNIT;
+
         Board(Sudoku::puzzle startGrid);
         Board(Sudoku::puzzle startGrid, Sudoku::puzzle finishGrid);
         Board(std::string gridString);
         bool isWon();
         bool isRemaining(char val) const;
+        bool isCorrect(int row, int col) const;
+        bool isConflict(int row, int col) const;
+        bool isComplete() const;
+        bool isSafe(int digit, int row, int col) const;
+        int getFilled() const;
+        std::uint64_t getHash() const;
+        std::uint64_t getGridHash() const;
 
-        const std::array<std::array<std::uint16_t, 9>, 9> &getPencilMarks();
+        const markTable &getPencilMarks() const;
         const Sudoku::puzzle &getStartGrid() const;
         const Sudoku::puzzle &getSolution() const;
 
         bool insert(char val, int row, int col);
         bool pencil(const char val, int row, int col);
         uint16_t getPencil(char row, char col) const;
+        const std::array<std::array<std::uint16_t, 9>, 27> &getPositions() const;
+        std::uint16_t getPositions(int unit, int digit) const;
         void autoPencil();
+        void setSquare(int row, int col, int val, std::uint16_t marks);
+        void assign(const Sudoku::puzzle &grid);
 
         void printSolution(std::ostream &stream) const;
         void printSolution() const;
@@ -75,3 +122,7 @@ class Board : public SimpleBoard {
         void swapStartGrid();
         void swapStartGrid(Sudoku::puzzle solution);
 };
+
+// Boards are copied for every hint worked out in the background and every
+// board graded, they should stay plain memory
+static_assert(std::is_trivially_copyable<Board>::value, "Board has to be trivially copyable");
@@ -0,0 +1,132 @@
+#include "Candidates.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CANDIDATES_AVX2
+#include <immintrin.h>
+#endif
+
+Sudoku::cellSet Candidates::Scalar::withCount(const std::uint16_t *marks, int count) {
+    Sudoku::cellSet found = {};
+    for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+        if (__builtin_popcount(marks[cell]) == count) {
+            found.add(cell);
+        }
+    }
+    return found;
+}
+
+Sudoku::cellSet Candidates::Scalar::withMoreThan(const std::uint16_t *marks, int count) {
+    Sudoku::cellSet found = {};
+    for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+        if (__builtin_popcount(marks[cell]) > count) {
+            found.add(cell);
+        }
+    }
+    return found;
+}
+
+#ifdef CANDIDATES_AVX2
+namespace {
+    // Registers of 16 squares, the last square doesn't fill one and is
+    // looked at on its own
+    const int LANES = 16;
+    const int REGISTERS = Sudoku::CELLS / LANES;
+
+    /**
+     * @brief Bit n is set if lane n of a is set, bit 16 + n for lane n of b
+     *
+     * Lanes have to be all ones or all zeros, as compares leave them.
+     */
+    __attribute__((target("avx2")))
+    inline std::uint32_t lanes(__m256i a, __m256i b) {
+        // packing interleaves the halves of a and b, put them back in order
+        __m256i bytes = _mm256_packs_epi16(a, b);
+        bytes = _mm256_permute4x64_epi64(bytes, 0xD8);
+        return (std::uint32_t)_mm256_movemask_epi8(bytes);
+    }
+
+    __attribute__((target("avx2")))
+    inline Sudoku::cellSet toSet(const __m256i (&found)[REGISTERS], bool last) {
+        __m256i zero = _mm256_setzero_si256();
+        std::uint64_t low = lanes(found[0], found[1]);
+        std::uint64_t high = lanes(found[2], found[3]);
+        std::uint64_t rest = lanes(found[4], zero) | (std::uint64_t)last << LANES;
+        return {{low | high << 32, rest}};
+    }
+
+    /**
+     * @brief Number of marks of every square in a register
+     */
+    __attribute__((target("avx2")))
+    inline __m256i countMarks(__m256i squares) {
+        // bits set in every nibble, looked up a byte at a time
+        const __m256i nibbleBits = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        __m256i low = _mm256_and_si256(squares, nibble);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(squares, 4), nibble);
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(nibbleBits, low),
+                                        _mm256_shuffle_epi8(nibbleBits, high));
+        // add the two bytes of every square
+        return _mm256_maddubs_epi16(bytes, _mm256_set1_epi8(1));
+    }
+
+    __attribute__((target("avx2")))
+    Sudoku::cellSet withCountAvx2(const std::uint16_t *marks, int count) {
+        __m256i wanted = _mm256_set1_epi16(count);
+        __m256i found[REGISTERS];
+        for (auto i = 0; i < REGISTERS; i++) {
+            __m256i squares = _mm256_loadu_si256((const __m256i *)(marks + i * LANES));
+            found[i] = _mm256_cmpeq_epi16(countMarks(squares), wanted);
+        }
+        return toSet(found, __builtin_popcount(marks[Sudoku::CELLS - 1]) == count);
+    }
+
+    __attribute__((target("avx2")))
+    Sudoku::cellSet withMoreThanAvx2(const std::uint16_t *marks, int count) {
+        __m256i limit = _mm256_set1_epi16(count);
+        __m256i found[REGISTERS];
+        for (auto i = 0; i < REGISTERS; i++) {
+            __m256i squares = _mm256_loadu_si256((const __m256i *)(marks + i * LANES));
+            found[i] = _mm256_cmpgt_epi16(countMarks(squares), limit);
+        }
+        return toSet(found, __builtin_popcount(marks[Sudoku::CELLS - 1]) > count);
+    }
+}
+#endif
+
+namespace {
+    struct kernels {
+        Sudoku::cellSet (*withCount)(const std::uint16_t *, int);
+        Sudoku::cellSet (*withMoreThan)(const std::uint16_t *, int);
+        bool vectorized;
+    };
+
+    kernels pick() {
+#ifdef CANDIDATES_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return {withCountAvx2, withMoreThanAvx2, true};
+        }
+#endif
+        return {Candidates::Scalar::withCount, Candidates::Scalar::withMoreThan, false};
+    }
+
+    const kernels &active() {
+        static const kernels chosen = pick();
+        return chosen;
+    }
+}
+
+Sudoku::cellSet Candidates::withCount(const std::uint16_t *marks, int count) {
+    return active().withCount(marks, count);
+}
+
+Sudoku::cellSet Candidates::withMoreThan(const std::uint16_t *marks, int count) {
+    return active().withMoreThan(marks, count);
+}
+
+bool Candidates::vectorized() {
+    return active().vectorized;
+}
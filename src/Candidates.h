@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include "Sudoku/Units.h"
+
+/**
+ * @brief Whole board scans of pencil marks
+ *
+ * Every function counts the pencil marks of all 81 squares, kept in row
+ * order as Board::markTable, and answers with a set of squares. With AVX2
+ * the marks are 16 squares to a register and a board takes five loads and
+ * a few instructions. They're for the techniques that look at every
+ * square, a unit or the peers of a square are faster to read one by one.
+ * Whether AVX2 is used is decided once at runtime, the Scalar versions
+ * are used on processors without it and give the same answers.
+ */
+namespace Candidates {
+    /**
+     * @brief Finds the squares with exactly count marks
+     *
+     * @param marks pencil marks of the 81 squares
+     * @param count of marks a square has to have
+     * @return squares with count marks pencilled in
+     */
+    Sudoku::cellSet withCount(const std::uint16_t *marks, int count);
+
+    /**
+     * @brief Finds the squares with more than count marks
+     *
+     * @param marks pencil marks of the 81 squares
+     * @param count of marks a square has to have more of
+     * @return squares with more than count marks pencilled in
+     */
+    Sudoku::cellSet withMoreThan(const std::uint16_t *marks, int count);
+
+    /**
+     * @brief True if the AVX2 versions are used
+     */
+    bool vectorized();
+
+    namespace Scalar {
+        Sudoku::cellSet withCount(const std::uint16_t *marks, int count);
+        Sudoku::cellSet withMoreThan(const std::uint16_t *marks, int count);
+    }
+}
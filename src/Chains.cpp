@@ -0,0 +1,94 @@
+#include "Chains.h"
+#include "Candidates.h"
+
+/**
+ * @brief Builds the graph and colours its components
+ *
+ * Components are found in the order of their first square, each with a
+ * breadth first search that only visits squares with the same pair that
+ * haven't been visited, so every square is coloured once.
+ *
+ * @param board pencil marked board
+ */
+ChainGraph::ChainGraph(const Board &board) {
+    std::array<std::uint16_t, Sudoku::CELLS> pairs = {};
+    Sudoku::cellSet unvisited = {};
+    Sudoku::cellSet twoMarks = Candidates::withCount(board.getPencilMarks().data(), 2);
+    for (; twoMarks.any(); twoMarks.remove(twoMarks.first())) {
+        int cell = twoMarks.first();
+        int row = Sudoku::ROW_OF[cell];
+        int col = Sudoku::COL_OF[cell];
+        if (!board.isEmpty(row, col)) continue;
+        pairs[cell] = board.getPencil(row, col);
+        unvisited.add(cell);
+    }
+
+    std::array<std::uint8_t, Sudoku::CELLS> queue;
+    while (unvisited.any()) {
+        int start = unvisited.first();
+        component found = {pairs[start], 0, {}};
+
+        Sudoku::cellSet samePair = {};
+        for (Sudoku::cellSet rest = unvisited; rest.any(); rest.remove(rest.first())) {
+            if (pairs[rest.first()] == found.pair) samePair.add(rest.first());
+        }
+
+        int head = 0;
+        int tail = 0;
+        std::array<std::uint8_t, Sudoku::CELLS> color;
+        queue[tail++] = start;
+        color[start] = 0;
+        samePair.remove(start);
+        unvisited.remove(start);
+        while (head < tail) {
+            int cell = queue[head++];
+            found.colors[color[cell]].add(cell);
+            found.size++;
+            Sudoku::cellSet linked = Sudoku::PEER_MASKS[cell] & samePair;
+            for (; linked.any(); linked.remove(linked.first())) {
+                int next = linked.first();
+                color[next] = color[cell] ^ 1;
+                queue[tail++] = next;
+                samePair.remove(next);
+                unvisited.remove(next);
+            }
+        }
+        components.push_back(found);
+    }
+}
+
+/**
+ * @brief Looks for a chain of pairs that removes a pencil mark
+ *
+ * A square that sees both colours of a component with at least 4 squares
+ * can't hold either digit of the pair, the digit it has is removed from
+ * the first such square.
+ *
+ * @param board the graph was built for
+ * @param pair digits of the chain as set bits
+ * @param moves vector that gets populated with found moves
+ * @return true if moves are found
+ * @return false otherwise
+ */
+bool ChainGraph::findChain(const Board &board, std::uint16_t pair, MoveList &moves) const {
+    for (auto &chain : components) {
+        if (chain.pair != pair || chain.size < 4) continue;
+        Sudoku::cellSet seen[2] = {};
+        for (auto i = 0; i < 2; i++) {
+            for (Sudoku::cellSet rest = chain.colors[i]; rest.any(); rest.remove(rest.first())) {
+                seen[i] = seen[i] | Sudoku::PEER_MASKS[rest.first()];
+            }
+        }
+        for (Sudoku::cellSet both = seen[0] & seen[1]; both.any(); both.remove(both.first())) {
+            int cell = both.first();
+            char row = Sudoku::ROW_OF[cell];
+            char col = Sudoku::COL_OF[cell];
+            if (!board.isEmpty(row, col)) continue;
+            std::uint16_t marks = board.getPencil(row, col) & pair;
+            if (marks == 0 || marks == pair) continue;
+            moves.push_back({(char)(__builtin_ctz(marks) + START_CHAR), row, col, &Board::pencil});
+            return true;
+        }
+    }
+    return false;
+}
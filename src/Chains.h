@@ -0,0 +1,27 @@
+#pragma once
+#include "HumanSolve.h"
+#include "Sudoku/Units.h"
+
+/**
+ * @brief Graph of the squares with exactly two pencil marks
+ *
+ * Two squares are linked when they have the same pair and see each other,
+ * then one of them holds the first digit of the pair and the other one
+ * the second. The graph is built once for a board and split into
+ * components, each coloured by which of the digits its squares hold.
+ */
+class ChainGraph {
+    private:
+        struct component {
+            std::uint16_t pair;
+            int size;
+            Sudoku::cellSet colors[2];
+        };
+
+        // At most 81 squares, so there can't be more components than that
+        FixedVector<component, Sudoku::CELLS> components;
+
+    public:
+        ChainGraph(const Board &board);
+        bool findChain(const Board &board, std::uint16_t pair, MoveList &moves) const;
+};
@@ -0,0 +1,325 @@
+#include "Database.h"
+#include "Sudoku/Packed.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+static const char DATA_MAGIC[8] = {'T', 'D', 'K', 'D', 'A', 'T', 'A', '1'};
+static const char INDEX_MAGIC[8] = {'T', 'D', 'K', 'I', 'N', 'D', 'X', '1'};
+static const std::size_t HEADER_SIZE = sizeof(DATA_MAGIC);
+static const std::size_t PACKED_SIZE = Sudoku::packed::BYTES;
+
+// puzzle, solution, empty cells, tier, hash
+static const std::size_t RECORD_SIZE = PACKED_SIZE * 2 + 2 + 8;
+// hash, record, empty cells, tier, padding
+static const std::size_t INDEX_SIZE = 8 + 4 + 2 + 2;
+
+static const int EMPTY_COUNTS = Sudoku::SIZE * Sudoku::SIZE + 1;
+
+/**
+ * @brief Writes a grid the way Sudoku::packed keeps it
+ */
+static void pack(const Sudoku::puzzle &grid, unsigned char *out) {
+    Sudoku::packed packed = Sudoku::pack(grid);
+    std::memcpy(out, packed.bytes.data(), PACKED_SIZE);
+}
+
+/**
+ * @brief Reads a grid written by pack
+ */
+static void unpack(const unsigned char *in, Sudoku::puzzle &grid) {
+    Sudoku::packed packed;
+    std::memcpy(packed.bytes.data(), in, PACKED_SIZE);
+    grid = Sudoku::unpack(packed);
+}
+
+static void writeInt(unsigned char *out, std::uint64_t val, int bytes) {
+    for (auto i = 0; i < bytes; i++) {
+        out[i] = (val >> (8 * i)) & 0xFF;
+    }
+}
+
+static std::uint64_t readInt(const unsigned char *in, int bytes) {
+    std::uint64_t val = 0;
+    for (auto i = 0; i < bytes; i++) {
+        val |= (std::uint64_t)in[i] << (8 * i);
+    }
+    return val;
+}
+
+/**
+ * @brief Opens or creates a database
+ *
+ * @param fileName file holding the records, the index is fileName.idx
+ */
+PuzzleDatabase::PuzzleDatabase(std::string fileName) : dataName(fileName), indexName(fileName + ".idx") {
+    records = 0;
+    buckets.resize((MAX_TIER + 2) * (EMPTY_COUNTS + 1));
+    std::random_device rd;
+    gen.seed(rd());
+    valid = readIndex();
+}
+
+/**
+ * @brief Gets the bucket holding the records with the given empty cells and tier
+ *
+ * Every record is put into the buckets for its exact values as well as the
+ * buckets where either or both of them are ANY.
+ */
+std::size_t PuzzleDatabase::bucket(int empty, int tier) {
+    return (tier + 1) * (EMPTY_COUNTS + 1) + (empty + 1);
+}
+
+/**
+ * @brief True if the empty cells and tier read from a file fit the buckets
+ */
+static bool indexable(int empty, int tier) {
+    return empty >= 0 && empty < EMPTY_COUNTS && tier >= 0 && tier <= PuzzleDatabase::MAX_TIER;
+}
+
+void PuzzleDatabase::addToIndex(std::uint32_t record, int empty, int tier, std::uint64_t hash) {
+    buckets[bucket(ANY, ANY)].push_back(record);
+    buckets[bucket(empty, ANY)].push_back(record);
+    buckets[bucket(ANY, tier)].push_back(record);
+    buckets[bucket(empty, tier)].push_back(record);
+    hashes.emplace(hash, record);
+}
+
+/**
+ * @brief Reads the index, creating the files if they do not exist
+ *
+ * Records that are missing from the index, for example if writing the
+ * index was interrupted, are read from the data file and indexed again.
+ * An index with an entry that doesn't fit, or a different length than the
+ * data file, is thrown away and built again.
+ *
+ * @return true if both files are databases
+ * @return false if either file is something else or a record is corrupt
+ */
+bool PuzzleDatabase::readIndex() {
+    std::fstream data(dataName, std::ios::in | std::ios::binary);
+    if (!data.good()) {
+        std::ofstream create(dataName, std::ios::binary);
+        create.write(DATA_MAGIC, HEADER_SIZE);
+        std::ofstream createIndex(indexName, std::ios::binary | std::ios::trunc);
+        createIndex.write(INDEX_MAGIC, HEADER_SIZE);
+        return create.good() && createIndex.good();
+    }
+    char magic[HEADER_SIZE];
+    data.read(magic, HEADER_SIZE);
+    if (!data.good() || !std::equal(magic, magic + HEADER_SIZE, DATA_MAGIC)) {
+        return false;
+    }
+    data.seekg(0, std::ios::end);
+    std::uint32_t stored = ((std::size_t)data.tellg() - HEADER_SIZE) / RECORD_SIZE;
+
+    std::ifstream index(indexName, std::ios::binary | std::ios::ate);
+    std::size_t indexSize = index.good() ? (std::size_t)index.tellg() : 0;
+    index.seekg(0);
+    bool hasIndex = index.good() && index.read(magic, HEADER_SIZE) && std::equal(magic, magic + HEADER_SIZE, INDEX_MAGIC);
+    unsigned char buffer[RECORD_SIZE];
+    while (hasIndex && records < stored && index.read((char *)buffer, INDEX_SIZE)) {
+        if (readInt(buffer + 8, 4) != records || !indexable(buffer[12], buffer[13])) {
+            hasIndex = false;
+            break;
+        }
+        addToIndex(records, buffer[12], buffer[13], readInt(buffer, 8));
+        records++;
+    }
+    index.close();
+    // A corrupt index is stale, and so is one with entries for records cut
+    // off the data file or half an entry at the end. It is built again
+    // from the data.
+    if (!hasIndex || indexSize != HEADER_SIZE + (std::size_t)records * INDEX_SIZE) {
+        hasIndex = false;
+        records = 0;
+        for (auto &indexed : buckets) {
+            indexed.clear();
+        }
+        hashes.clear();
+    }
+
+    std::ofstream appendIndex(indexName, std::ios::binary | (hasIndex ? std::ios::app : std::ios::trunc));
+    if (!hasIndex) {
+        appendIndex.write(INDEX_MAGIC, HEADER_SIZE);
+    }
+    data.seekg(HEADER_SIZE + (std::size_t)records * RECORD_SIZE);
+    while (records < stored && data.read((char *)buffer, RECORD_SIZE)) {
+        unsigned char entry[INDEX_SIZE] = {};
+        writeInt(entry, readInt(buffer + PACKED_SIZE * 2 + 2, 8), 8);
+        writeInt(entry + 8, records, 4);
+        entry[12] = buffer[PACKED_SIZE * 2];
+        entry[13] = buffer[PACKED_SIZE * 2 + 1];
+        if (!indexable(entry[12], entry[13])) {
+            return false;
+        }
+        appendIndex.write((char *)entry, INDEX_SIZE);
+        addToIndex(records, entry[12], entry[13], readInt(entry, 8));
+        records++;
+    }
+    return appendIndex.good();
+}
+
+bool PuzzleDatabase::isValid() const {
+    return valid;
+}
+
+std::uint32_t PuzzleDatabase::size() const {
+    return records;
+}
+
+/**
+ * @brief Number of records with the given empty cells and tier
+ *
+ * @param empty number of empty cells or ANY
+ * @param tier difficulty tier or ANY
+ */
+std::uint32_t PuzzleDatabase::count(int empty, int tier) const {
+    if (empty < ANY || empty >= EMPTY_COUNTS || tier < ANY || tier > MAX_TIER) {
+        return 0;
+    }
+    return buckets[bucket(empty, tier)].size();
+}
+
+/**
+ * @brief Adds a puzzle to the end of the database
+ *
+ * @param puzzle to add
+ * @param solution of the puzzle
+ * @param tier difficulty of the puzzle
+ * @return true if the puzzle was added
+ * @return false if an equivalent puzzle is already stored or writing failed
+ */
+bool PuzzleDatabase::append(const Sudoku::puzzle &puzzle, const Sudoku::puzzle &solution, int tier) {
+    if (!valid) {
+        return false;
+    }
+    std::uint64_t hash = canonicalHash(puzzle);
+    if (hashes.count(hash) != 0) {
+        return false;
+    }
+    tier = std::max(0, std::min(tier, (int)MAX_TIER));
+    int empty = 0;
+    for (auto &row : puzzle) {
+        empty += std::count(row.begin(), row.end(), 0);
+    }
+
+    unsigned char record[RECORD_SIZE];
+    pack(puzzle, record);
+    pack(solution, record + PACKED_SIZE);
+    record[PACKED_SIZE * 2] = empty;
+    record[PACKED_SIZE * 2 + 1] = tier;
+    writeInt(record + PACKED_SIZE * 2 + 2, hash, 8);
+
+    unsigned char entry[INDEX_SIZE] = {};
+    writeInt(entry, hash, 8);
+    writeInt(entry + 8, records, 4);
+    entry[12] = empty;
+    entry[13] = tier;
+
+    std::ofstream data(dataName, std::ios::binary | std::ios::app);
+    data.write((char *)record, RECORD_SIZE);
+    data.close();
+    std::ofstream index(indexName, std::ios::binary | std::ios::app);
+    index.write((char *)entry, INDEX_SIZE);
+    if (!data.good() || !index.good()) {
+        return false;
+    }
+    addToIndex(records, empty, tier, hash);
+    records++;
+    return true;
+}
+
+bool PuzzleDatabase::read(std::uint32_t record, entry &out) {
+    std::ifstream data(dataName, std::ios::binary);
+    data.seekg(HEADER_SIZE + (std::size_t)record * RECORD_SIZE);
+    unsigned char buffer[RECORD_SIZE];
+    if (!data.read((char *)buffer, RECORD_SIZE)) {
+        return false;
+    }
+    unpack(buffer, out.puzzle);
+    unpack(buffer + PACKED_SIZE, out.solution);
+    out.empty = buffer[PACKED_SIZE * 2];
+    out.tier = buffer[PACKED_SIZE * 2 + 1];
+    out.hash = readInt(buffer + PACKED_SIZE * 2 + 2, 8);
+    return true;
+}
+
+/**
+ * @brief Reads the record at the given position
+ */
+bool PuzzleDatabase::get(std::uint32_t record, entry &out) {
+    if (!valid || record >= records) {
+        return false;
+    }
+    return read(record, out);
+}
+
+/**
+ * @brief Reads a random record with the given empty cells and tier
+ *
+ * @param empty number of empty cells or ANY
+ * @param tier difficulty tier or ANY
+ * @param out set to the record
+ * @return true if there was a matching record
+ */
+bool PuzzleDatabase::random(int empty, int tier, entry &out) {
+    if (count(empty, tier) == 0) {
+        return false;
+    }
+    const auto &matching = buckets[bucket(empty, tier)];
+    std::uniform_int_distribution<std::size_t> distrib(0, matching.size() - 1);
+    return read(matching[distrib(gen)], out);
+}
+
+/**
+ * @brief Reads the record of a puzzle with the given canonical hash
+ */
+bool PuzzleDatabase::find(std::uint64_t hash, entry &out) {
+    auto found = hashes.find(hash);
+    if (found == hashes.end()) {
+        return false;
+    }
+    return read(found->second, out);
+}
+
+/**
+ * @brief Hashes a puzzle so that rotated, reflected and relabelled copies get the same hash
+ *
+ * Each of the 8 rotations and reflections has its digits renumbered in
+ * the order they first appear, and the smallest of those grids is hashed.
+ *
+ * @param grid puzzle to hash
+ * @return std::uint64_t FNV-1a hash of the canonical grid
+ */
+std::uint64_t PuzzleDatabase::canonicalHash(const Sudoku::puzzle &grid) {
+    const int last = Sudoku::SIZE - 1;
+    std::array<unsigned char, Sudoku::SIZE * Sudoku::SIZE> best;
+    best.fill(0xFF);
+    for (auto transform = 0; transform < 8; transform++) {
+        std::array<unsigned char, Sudoku::SIZE * Sudoku::SIZE> current;
+        std::array<unsigned char, Sudoku::SIZE + 1> labels = {};
+        unsigned char next = 1;
+        for (auto i = 0; i < Sudoku::SIZE; i++) {
+            for (auto j = 0; j < Sudoku::SIZE; j++) {
+                int row = (transform & 1) ? last - i : i;
+                int col = (transform & 2) ? last - j : j;
+                int val = (transform & 4) ? grid[col][row] : grid[row][col];
+                if (val != 0 && labels[val] == 0) {
+                    labels[val] = next++;
+                }
+                current[i * Sudoku::SIZE + j] = labels[val];
+            }
+        }
+        if (current < best) {
+            best = current;
+        }
+    }
+
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (auto val : best) {
+        hash ^= val;
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
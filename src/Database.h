@@ -0,0 +1,55 @@
+#pragma once
+#include "Sudoku/Sudoku.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief File of packed puzzles and their solutions
+ *
+ * Puzzles are stored as fixed size records so any record can be read
+ * with a single seek. A second file with the same name ending in .idx
+ * holds the empty cell count, difficulty tier and canonical hash of every
+ * record, which is all that is read when the database is opened.
+ */
+class PuzzleDatabase {
+    public:
+        struct entry {
+            Sudoku::puzzle puzzle;
+            Sudoku::puzzle solution;
+            int empty;
+            int tier;
+            std::uint64_t hash;
+        };
+        static const int ANY = -1;
+        static const int MAX_TIER = 31;
+
+    private:
+        std::string dataName;
+        std::string indexName;
+        std::uint32_t records;
+        bool valid;
+        std::vector<std::vector<std::uint32_t>> buckets;
+        std::unordered_map<std::uint64_t, std::uint32_t> hashes;
+        std::mt19937 gen;
+
+        static std::size_t bucket(int empty, int tier);
+        void addToIndex(std::uint32_t record, int empty, int tier, std::uint64_t hash);
+        bool readIndex();
+        bool read(std::uint32_t record, entry &out);
+
+    public:
+        PuzzleDatabase(std::string fileName);
+        bool isValid() const;
+        std::uint32_t size() const;
+        std::uint32_t count(int empty, int tier) const;
+
+        bool append(const Sudoku::puzzle &puzzle, const Sudoku::puzzle &solution, int tier);
+        bool get(std::uint32_t record, entry &out);
+        bool random(int empty, int tier, entry &out);
+        bool find(std::uint64_t hash, entry &out);
+
+        static std::uint64_t canonicalHash(const Sudoku::puzzle &grid);
+};
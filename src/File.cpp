@@ -179,3 +179,52 @@ std::vector<SimpleBoard> file::getTuidokuPuzzle(std::istream &file) {
     //return std::vector<SimpleBoard>{Generator{puzzleStream.str().c_str()}.createSimpleBoard()};
     return std::vector<SimpleBoard>{SimpleBoard(puzzleStream.str())};
 }
+
+
+/**
+ * @brief Reads a clue mask from a file or from the string itself
+ *
+ * @param maskString name of a file containing the mask, or the mask
+ * @param mask set to the positions of the clues
+ * @return false if there aren't exactly 81 squares in the mask
+ */
+bool file::getMask(const char *maskString, Sudoku::mask &mask) {
+    std::ifstream file;
+    file.open(maskString);
+    if (file.good()) {
+        return getMask(file, mask);
+    }
+    std::stringstream stream(maskString);
+    return getMask(stream, mask);
+}
+
+/**
+ * @brief Parses a clue mask in the style of an sdm line
+ *
+ * X and digits mark given cells, '.' and '0' mark empty cells.
+ * Lines starting with # are skipped.
+ *
+ * @param file containing the mask
+ * @param mask set to the positions of the clues
+ * @return false if there aren't exactly 81 squares in the mask
+ */
+bool file::getMask(std::istream &file, Sudoku::mask &mask) {
+    mask = {};
+    std::string line;
+    int idx = 0;
+    while (getline(file, line)) {
+        if (!line.empty() && line.front() == '#')
+            continue;
+        for (char c : line) {
+            bool clue = ('1' <= c && '9' >= c) || 'X' == c || 'x' == c;
+            if (!clue && '.' != c && '0' != c) {
+                continue;
+            }
+            if (idx < Sudoku::SIZE * Sudoku::SIZE) {
+                mask[idx / Sudoku::SIZE][idx % Sudoku::SIZE] = clue;
+            }
+            idx++;
+        }
+    }
+    return idx == Sudoku::SIZE * Sudoku::SIZE;
+}
@@ -10,4 +10,6 @@ namespace file {
     std::vector<SimpleBoard> getPuzzle(const char *fileName);
     std::vector<SimpleBoard> getStringPuzzle(const char *puzzleString);
     std::vector<SimpleBoard> getTuidokuPuzzle(std::istream &file);
+    bool getMask(std::istream &file, Sudoku::mask &mask);
+    bool getMask(const char *maskString, Sudoku::mask &mask);
 }
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+/**
+ * @brief Vector with a fixed capacity that never allocates
+ *
+ * The capacity has to be large enough for everything that can be pushed.
+ * Pushing past it is asserted against, and with NDEBUG the item is
+ * dropped.
+ */
+template <typename T, std::size_t N>
+class FixedVector {
+    private:
+        std::array<T, N> items;
+        std::size_t count = 0;
+
+    public:
+        void push_back(const T &item) {
+            assert(count < N && "FixedVector is full");
+            if (count < N) {
+                items[count++] = item;
+            }
+        }
+
+        /**
+         * @brief Removes the item at index, keeping the order of the rest
+         */
+        void erase(std::size_t index) {
+            for (auto i = index + 1; i < count; i++) {
+                items[i - 1] = items[i];
+            }
+            count--;
+        }
+
+        void clear() {
+            count = 0;
+        }
+
+        std::size_t size() const {
+            return count;
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        T &operator[](std::size_t index) {
+            return items[index];
+        }
+
+        const T &operator[](std::size_t index) const {
+            return items[index];
+        }
+
+        T *begin() {
+            return items.data();
+        }
+
+        T *end() {
+            return items.data() + count;
+        }
+
+        const T *begin() const {
+            return items.data();
+        }
+
+        const T *end() const {
+            return items.data() + count;
+        }
+};
@@ -157,10 +157,14 @@ int InteractiveSolver::mainLoop() {
             break;
         default:
             if ((ch >= START_CHAR - 1 && ch <= START_CHAR + 8) || ch == ERASE_KEY) {
-                if (Sudoku::isSafe(board->getPlayGrid(), row, col, ch - '0')) {
+                if (board->isSafe(ch - '0', row, col)) {
                     board->insert(ch, row, col);
-                    Sudoku::puzzle solveGrid = board->getPlayGrid();
-                    bool isUnique = Sudoku::solve(solveGrid);
+                    bool isUnique;
+                    if (!unique.get(board->getGridHash(), isUnique)) {
+                        Sudoku::puzzle solveGrid = board->getPlayGrid();
+                        isUnique = Sudoku::solve(solveGrid);
+                        unique.put(board->getGridHash(), isUnique);
+                    }
                     if (isUnique) {
                         board->swapStartGrid(board->getPlayGrid());
                         solve();
@@ -181,14 +185,10 @@ int InteractiveSolver::mainLoop() {
 void InteractiveSolver::solve() {
     auto solution = board->getPlayGrid();
     Sudoku::solve(solution);
-    for (auto i = 0; i < solution.size(); i++) {
-        for (auto j = 0; j < solution[i].size(); j++) {
-            board->insert(solution[i][j] + '0', i, j);
-        }
-    }
+    board->assign(solution);
 }
 
-Game::Game(Window *win, bool big): Controller(win) {
+Game::Game(Window *win, bool big): Controller(win), hints(*board) {
     window = win;
     mode = INSERT_KEY;
     isBig = big;
@@ -237,7 +237,15 @@ int Game::mainLoop() {
             window->check();
             break;
         case AUTO_PENCIL_KEY:
-            board->autoPencil();
+            journal.autoPencil(*board);
+            break;
+        case UNDO_KEY:
+            hints_since_move = 0;
+            journal.undo(*board);
+            break;
+        case REDO_KEY:
+            hints_since_move = 0;
+            journal.redo(*board);
             break;
         case TOGGLE_KEY:
             mode == INSERT_KEY ? changeMode(PENCIL_KEY) : changeMode(INSERT_KEY);
@@ -251,14 +259,16 @@ int Game::mainLoop() {
                 hints_since_move = 0;
                 window->select(ch);
                 if (mode == INSERT_KEY) {
-                    board->insert(ch, row, col);
+                    journal.insert(*board, ch, row, col);
                 }
                 else if (mode == PENCIL_KEY) {
-                    board->pencil(ch, row, col);
+                    journal.pencil(*board, ch, row, col);
                 }
             }
         }
 
+        // start on the next hint while the player thinks
+        hints.update(*board);
         board->isWon();
     }
     if (START_TIMER)
@@ -299,16 +309,14 @@ void Game::changeMode(char c) {
 void Game::getHint() {
     static Hint hint;
     if (hints_since_move == 1) {
-        hint = solveHuman(*board);
-        window->changeMode(hint.hint1);
+        hint = hints.get(*board);
+        window->changeMode(hint.hint1());
     }
     else if (hints_since_move == 2) {
-        window->changeMode(hint.hint2);
+        window->changeMode(hint.hint2());
     }
     else if (hints_since_move > 2) {
-        for (auto &move : hint.moves) {
-            move(board);
-        }
+        journal.apply(*board, hint);
         hints_since_move = 0;
     }
 }
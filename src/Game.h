@@ -4,6 +4,9 @@
 #include "Board.h"
 #include "Sudoku/Sudoku.h"
 #include "HumanSolve.h"
+#include "HintWorker.h"
+#include "Journal.h"
+#include "LruCache.h"
 #include <vector>
 
 class Controller {
@@ -25,6 +28,8 @@ class Controller {
 class InteractiveSolver : public Controller {
     private:
         SolveWindow *window;
+        // if the grid has a single solution, by the hash of the grid
+        LruCache<bool, 64> unique;
         void solve();
     public:
         InteractiveSolver(SolveWindow *win);
@@ -37,6 +42,8 @@ class Game : public Controller {
         wchar_t mode;
         bool isBig;
         int hints_since_move;
+        HintWorker hints;
+        Journal journal;
         void getHint();
     public:
         Game(Window *win, bool big);
@@ -0,0 +1,90 @@
+#include "HintWorker.h"
+#include <chrono>
+
+// No timeout, wait_until keeps clear of the newer libstdc++ symbol plain
+// wait needs, see ThreadPool.cpp
+static const auto NO_DEADLINE = std::chrono::steady_clock::time_point::max();
+
+/**
+ * @brief Starts working out the hint for the board straight away
+ */
+HintWorker::HintWorker(const Board &board)
+    : latest(board), generation(1), hintGeneration(0), stopping(false), snapshot(board), solver(snapshot) {
+    worker = std::thread(&HintWorker::work, this);
+}
+
+HintWorker::~HintWorker() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+/**
+ * @brief Works out a hint for every new copy of the board until stopped
+ */
+void HintWorker::work() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait_until(guard, NO_DEADLINE, [&] { return stopping || hintGeneration != generation; });
+        if (stopping) {
+            return;
+        }
+        std::size_t working = generation;
+        snapshot = latest;
+        guard.unlock();
+
+        Hint next;
+        if (!cache.get(snapshot.getHash(), next)) {
+            next = solver.nextHint();
+            cache.put(snapshot.getHash(), next);
+        }
+
+        guard.lock();
+        hint = next;
+        hintGeneration = working;
+        ready.notify_all();
+    }
+}
+
+/**
+ * @brief Checks if the board differs from the last copy, lock has to be held
+ */
+bool HintWorker::changed(Board &board) {
+    return board.getPlayGrid() != latest.getPlayGrid() || board.getPencilMarks() != latest.getPencilMarks();
+}
+
+/**
+ * @brief Hands in the board, the worker starts over if it changed
+ *
+ * @param board the player is playing
+ */
+void HintWorker::update(Board &board) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!changed(board)) {
+            return;
+        }
+        latest = board;
+        generation++;
+    }
+    wake.notify_all();
+}
+
+/**
+ * @brief Gets the hint for the board
+ *
+ * Returns straight away when the worker already has it, otherwise waits
+ * for the worker to finish it.
+ *
+ * @param board the player is playing
+ * @return Hint the same hint solveHuman gives for the board
+ */
+Hint HintWorker::get(Board &board) {
+    update(board);
+    std::unique_lock<std::mutex> guard(lock);
+    ready.wait_until(guard, NO_DEADLINE, [&] { return hintGeneration == generation; });
+    return hint;
+}
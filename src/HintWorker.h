@@ -0,0 +1,50 @@
+#pragma once
+#include "Board.h"
+#include "HumanSolve.h"
+#include "LruCache.h"
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Works out the next hint in the background while the player thinks
+ *
+ * The worker keeps a copy of the board and a solver session on it. Every
+ * time the board is handed in and differs from the last copy the worker
+ * starts on the new copy, a hint for an older copy is thrown away. Asking
+ * for the hint only waits if the worker hasn't finished the latest copy.
+ * Hints are cached by the hash of the board, going back to a position,
+ * like erasing a digit and entering it again, doesn't solve it again.
+ */
+class HintWorker {
+    private:
+        std::thread worker;
+        std::mutex lock;
+        std::condition_variable wake;
+        std::condition_variable ready;
+
+        // Guarded by lock
+        Board latest;
+        std::size_t generation;
+        Hint hint;
+        std::size_t hintGeneration;
+        bool stopping;
+
+        // Only used by the worker
+        Board snapshot;
+        HumanSolver solver;
+        LruCache<Hint, 32> cache;
+
+        void work();
+        bool changed(Board &board);
+
+    public:
+        HintWorker(const Board &board);
+        ~HintWorker();
+        HintWorker(const HintWorker &) = delete;
+        HintWorker &operator=(const HintWorker &) = delete;
+
+        void update(Board &board);
+        Hint get(Board &board);
+};
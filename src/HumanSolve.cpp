@@ -1,16 +1,13 @@
 #include "HumanSolve.h"
-#include <map>
-#include <unordered_set>
+#include "Chains.h"
+#include "Candidates.h"
 #include <utility>
 #include <algorithm>
+#include <climits>
 #include <sstream>
 
-struct Coord {
-    char i;
-    char j;
-};
 
-static std::string getGenericHint(std::vector<Move> moves) {
+static std::string getGenericHint(const MoveList &moves) {
     std::stringstream ret;
     ret << "Look closer at the digit ";
     ret << moves[0].val;
@@ -23,45 +20,51 @@ static std::string getGenericHint(std::vector<Move> moves) {
     return ret.str();
 }
 
-static void getCombinations(int offset, int k, std::uint16_t combinations, std::vector<std::uint16_t> &final) {
+static void getCombinations(int offset, int k, std::uint16_t combinations, std::uint16_t *final, std::size_t &count) {
     if (k == 0) {
-        final.emplace_back(combinations);
+        final[count++] = combinations;
         return;
     }
 
     for (int i = offset; i < 9; i++) {
         combinations |= (1 << i);
-        getCombinations(i + 1, k - 1, combinations, final);
+        getCombinations(i + 1, k - 1, combinations, final, count);
         combinations &= ~(1 << i);
     }
 }
 
-static std::vector<uint16_t> getCombinations(int k) {
-    std::vector<uint16_t> final;
-    getCombinations(0, k, 0, final);
+/**
+ * @brief Gets every combination of k digits
+ * 
+ * @tparam N number of combinations, 9 choose k
+ * @param k number of digits in each combination
+ * @return std::array<std::uint16_t, N> combinations as set bits
+ */
+template <std::size_t N>
+static std::array<std::uint16_t, N> getCombinations(int k) {
+    std::array<std::uint16_t, N> final = {};
+    std::size_t count = 0;
+    getCombinations(0, k, 0, final.data(), count);
     return final;
 }
 
-static int countBits(std::uint16_t bits) {
-    int count = 0;
-    while (bits != 0) {
-        if ((bits & 1) == 1) {
-            count++;
-        }
-        bits >>=1;
-    }
-    return count;
+static const auto all_singles = getCombinations<9>(1);
+static const auto all_doubles = getCombinations<36>(2);
+static const auto all_triples = getCombinations<84>(3);
+static const auto all_quads = getCombinations<126>(4);
+
+static inline int countBits(std::uint16_t bits) {
+    return __builtin_popcount(bits);
 }
 
- static std::vector<char> getSetBits(std::uint16_t bits) {
-    std::vector<char> nums;
-    for (unsigned char num = 0; num < 9; num++) {
-        if ((bits & (1 << num)) != 0) {
-            nums.push_back(num);
-        }
-    }
-    return nums;
- }
+/**
+ * @brief Gets the lowest set bit, bits can not be 0
+ * 
+ * Set bits are iterated with for (; bits != 0; bits &= bits - 1) firstBit(bits)
+ */
+static inline char firstBit(std::uint16_t bits) {
+    return __builtin_ctz(bits);
+}
 
 static char countOccurrencesNaked(Board &board, std::uint16_t bits, char i_min, char i_max, char j_min, char j_max, std::uint16_t &seen_i, std::uint16_t &seen_j) {
     char count = 0;
@@ -80,26 +83,43 @@ static char countOccurrencesNaked(Board &board, std::uint16_t bits, char i_min,
     return count;
 }
 
-static char countOccurrencesHidden(Board &board, std::uint16_t bits, char i_min, char i_max, char j_min, char j_max, std::uint16_t &seen_i, std::uint16_t &seen_j) {
-   char count = 0;
-   std::uint16_t seen_vals = 0;
-   for (auto i = i_min; i < i_max; i++) {
-        for (auto j = j_min; j < j_max; j++) {
-            if (!board.isEmpty(i, j)) continue;
-            auto marks = board.getPencil(i ,j);
-            if ((marks & bits) != 0) {
-                seen_i |= (1 << i);
-                seen_j |= (1 << j);
-                seen_vals |= (marks & bits);
-                count++;
-            }
+/**
+ * @brief Counts the squares in a unit where any of the digits are pencilled in
+ * 
+ * @param board to count in
+ * @param bits digits to look for as set bits
+ * @param unit index of the unit in the board position table
+ * @param seen_i set bits get added for the rows the digits are found in
+ * @param seen_j set bits get added for the columns the digits are found in
+ * @return char number of squares, 0xFF if any of the digits is missing from the unit
+ */
+static char countOccurrencesHidden(Board &board, std::uint16_t bits, int unit, std::uint16_t &seen_i, std::uint16_t &seen_j) {
+    const auto &positions = board.getPositions()[unit];
+    std::uint16_t found = 0;
+    for (auto num = 0; num < 9; num++) {
+        if ((bits & (1 << num)) == 0) continue;
+        if (positions[num] == 0) return 0xFF;
+        found |= positions[num];
+    }
+    if (unit < Board::COL_UNIT) {
+        seen_i |= (1 << (unit - Board::ROW_UNIT));
+        seen_j |= found;
+    }
+    else if (unit < Board::BOX_UNIT) {
+        seen_i |= found;
+        seen_j |= (1 << (unit - Board::COL_UNIT));
+    }
+    else {
+        for (std::uint16_t pos = found; pos != 0; pos &= pos - 1) {
+            int cell = Sudoku::UNIT_CELLS[unit][firstBit(pos)];
+            seen_i |= (1 << Sudoku::ROW_OF[cell]);
+            seen_j |= (1 << Sudoku::COL_OF[cell]);
         }
     }
-    if (seen_vals != bits) return 0xFF;
-    return count;
+    return countBits(found);
 }
 
-static bool removedOccurrencesNaked(Board &board, std::uint16_t bits, char i_min, char i_max, char j_min, char j_max, std::vector<Move> &moves) {
+static bool removedOccurrencesNaked(Board &board, std::uint16_t bits, char i_min, char i_max, char j_min, char j_max, MoveList &moves) {
     bool ret = false;
     for (auto i = i_min; i < i_max; i++) {
         for (auto j = j_min; j < j_max; j++) {
@@ -108,8 +128,8 @@ static bool removedOccurrencesNaked(Board &board, std::uint16_t bits, char i_min
             if ((marks & ~(bits)) == 0) continue; // Only marks are set here
             marks &= bits; // marks == bits that should be removed
             if ((marks) == 0) continue; // no marks set here
-            auto set_bits = getSetBits(marks);
-            for (auto &num : set_bits) {
+            for (; marks != 0; marks &= marks - 1) {
+                char num = firstBit(marks);
                 //board.pencil(num + START_CHAR, i, j);
                 Move move = {
                     (char)(num + START_CHAR), i, j, &Board::pencil
@@ -122,7 +142,7 @@ static bool removedOccurrencesNaked(Board &board, std::uint16_t bits, char i_min
     return ret;
 }
 
-static bool removedOccurrencesHidden(Board &board, std::uint16_t bits, char i_min, char i_max, char j_min, char j_max, std::vector<Move> &moves) {
+static bool removedOccurrencesHidden(Board &board, std::uint16_t bits, char i_min, char i_max, char j_min, char j_max, MoveList &moves) {
     bool ret = false;
     for (auto i = i_min; i < i_max; i++) {
         for (auto j = j_min; j < j_max; j++) {
@@ -130,8 +150,8 @@ static bool removedOccurrencesHidden(Board &board, std::uint16_t bits, char i_mi
             std::uint16_t marks = board.getPencil(i, j);
             if ((marks & bits) == 0) continue;
             marks &= ~bits;
-            auto set_bits = getSetBits(marks);
-            for (auto &num : set_bits) {
+            for (; marks != 0; marks &= marks - 1) {
+                char num = firstBit(marks);
                 //board->pencil(num + START_CHAR, i, j);
                 Move move = {
                     (char)(num + START_CHAR), i, j, &Board::pencil
@@ -145,171 +165,639 @@ static bool removedOccurrencesHidden(Board &board, std::uint16_t bits, char i_mi
 }
 
 
-Hint solveHuman(Board &board) {
-    Hint hint = {
-        "",
-        "",
-        0,
-        {},
-    };
+/**
+ * @brief Gets the index of every combination in the list of its size
+ */
+static std::array<std::uint8_t, 512> makeComboIndex() {
+    std::array<std::uint8_t, 512> index = {};
+    for (std::size_t i = 0; i < all_doubles.size(); i++) index[all_doubles[i]] = i;
+    for (std::size_t i = 0; i < all_triples.size(); i++) index[all_triples[i]] = i;
+    for (std::size_t i = 0; i < all_quads.size(); i++) index[all_quads[i]] = i;
+    return index;
+}
 
-    if (board.isWon()){
-        hint.hint1 = "Board is solved!";
-        hint.hint2 = "Board is solved!";
-        return hint;
+static const auto COMBO_INDEX = makeComboIndex();
+
+/**
+ * @brief Gets the order findNaked and findHidden search the units in
+ * 
+ * Boxes first, then row 0, column 0, row 1 and so on.
+ */
+static constexpr std::array<std::uint8_t, 27> makeUnitOrder() {
+    std::array<std::uint8_t, 27> order = {};
+    for (auto i = 0; i < 9; i++) {
+        order[Board::BOX_UNIT + i] = i;
+        order[Board::ROW_UNIT + i] = 9 + 2 * i;
+        order[Board::COL_UNIT + i] = 10 + 2 * i;
     }
+    return order;
+}
 
-    static auto all_singles = getCombinations(1);
-    static auto all_doubles = getCombinations(2);
-    static auto all_triples = getCombinations(3);
-    static auto all_quads = getCombinations(4);
-    for (auto &num : all_singles) {
-        Move single_move;
-        if (findNakedSingles(board, num, &single_move)) {
-            //return true;
-            hint.moves.push_back(single_move);
-            std::stringstream hint_1_stream;
-            std::stringstream hint_2_stream;
-            hint_1_stream << "Look closer at the digit " << hint.moves[0].val;
-            hint_2_stream << "row " << (char)(hint.moves[0].row + START_CHAR) << " column " << (char)(hint.moves[0].col + START_CHAR) << " can only be " << hint.moves[0].val;
-            hint.hint1 = hint_1_stream.str();
-            hint.hint2 = hint_2_stream.str();
-            hint.difficulty = 1;
-            return hint;
+static constexpr auto UNIT_ORDER = makeUnitOrder();
 
+/**
+ * @brief Naked or hidden subset found in a unit
+ * 
+ * Subsets are ordered like solveHuman looks for them, by their digits
+ * in the order of the combinations and then by the order of the unit.
+ */
+struct subset {
+    std::uint16_t digits;
+    int unit;
+
+    int order() const {
+        return digits == 0 ? INT_MAX : COMBO_INDEX[digits] * 27 + UNIT_ORDER[unit];
+    }
+};
+
+static const std::pair<const std::uint16_t *, std::size_t> getSubsetCombinations(int size) {
+    switch (size) {
+        case 2:
+        return {all_doubles.data(), all_doubles.size()};
+        case 3:
+        return {all_triples.data(), all_triples.size()};
+        case 4:
+        return {all_quads.data(), all_quads.size()};
+    }
+    return {nullptr, 0};
+}
+
+/**
+ * @brief Gets the rows and columns of a unit
+ */
+static void getUnitBounds(int unit, char &i_min, char &i_max, char &j_min, char &j_max) {
+    if (unit < Board::COL_UNIT) {
+        i_min = unit - Board::ROW_UNIT;
+        i_max = i_min + 1;
+        j_min = 0;
+        j_max = 9;
+    }
+    else if (unit < Board::BOX_UNIT) {
+        i_min = 0;
+        i_max = 9;
+        j_min = unit - Board::COL_UNIT;
+        j_max = j_min + 1;
+    }
+    else {
+        i_min = ((unit - Board::BOX_UNIT) / 3) * 3;
+        i_max = i_min + 3;
+        j_min = ((unit - Board::BOX_UNIT) % 3) * 3;
+        j_max = j_min + 3;
+    }
+}
+
+/**
+ * @brief Finds the first naked subset of a size that removes pencil marks
+ * 
+ * Instead of trying every combination of digits in every unit the
+ * combinations of squares in each unit with at most size pencil marks
+ * are tried, the digits of the subset are the marks of those squares.
+ * The result is the same subset findNaked finds when it is called with
+ * every combination in order.
+ * 
+ * @param board to search through
+ * @param size number of digits in the subset
+ * @param units units to search as set bits, see ALL_UNITS
+ * @return subset the first subset, with no digits if there is none
+ */
+static subset firstNakedSubset(Board &board, int size, std::uint32_t units) {
+    subset best = {0, 0};
+    auto combinations = getSubsetCombinations(size);
+    for (auto unit = 0; unit < 27; unit++) {
+        if ((units & (1u << unit)) == 0) continue;
+        std::array<std::uint16_t, 9> marks;
+        std::uint16_t small = 0;
+        for (auto pos = 0; pos < 9; pos++) {
+            int cell = Sudoku::UNIT_CELLS[unit][pos];
+            int row = Sudoku::ROW_OF[cell];
+            int col = Sudoku::COL_OF[cell];
+            marks[pos] = board.isEmpty(row, col) ? board.getPencil(row, col) : 0;
+            int count = countBits(marks[pos]);
+            if (count >= 1 && count <= size) small |= (1 << pos);
         }
-        if (findHiddenSingles(board, num, &single_move)) {
-            hint.moves.push_back(single_move);
-            std::stringstream hint_1_stream;
-            std::stringstream hint_2_stream;
-            hint_1_stream << "Look closer at the digit " << hint.moves[0].val;
-            hint_2_stream << "row " << (char)(hint.moves[0].row + START_CHAR) << " column " << (char)(hint.moves[0].col + START_CHAR) << " is the only possible location for " << hint.moves[0].val;
-            hint.hint1 = hint_1_stream.str();
-            hint.hint2 = hint_2_stream.str();
-            hint.difficulty = 2;
-            return hint;
+        if (countBits(small) < size) continue;
+
+        // Checks if the digits are a subset in this unit that removes marks
+        auto isSubset = [&](std::uint16_t digits) {
+            int count = 0;
+            bool removes = false;
+            for (auto pos = 0; pos < 9; pos++) {
+                if (marks[pos] == 0) continue;
+                if ((marks[pos] | digits) == digits) count++;
+                else if ((marks[pos] & digits) != 0) removes = true;
+            }
+            return count == size && removes;
+        };
+
+        for (std::size_t n = 0; n < combinations.second; n++) {
+            std::uint16_t squares = combinations.first[n];
+            if ((squares & small) != squares) continue;
+            std::uint16_t digits = 0;
+            for (std::uint16_t rest = squares; rest != 0; rest &= rest - 1) {
+                digits |= marks[firstBit(rest)];
+            }
+            if (countBits(digits) > size) continue;
+
+            subset found = {digits, unit};
+            if (countBits(digits) == size) {
+                if (found.order() < best.order() && isSubset(digits)) best = found;
+                continue;
+            }
+            // Fewer digits than squares, any digits can be added to them
+            for (std::size_t m = 0; m < combinations.second; m++) {
+                found.digits = combinations.first[m];
+                if ((found.digits & digits) != digits) continue;
+                if (found.order() >= best.order()) break;
+                if (isSubset(found.digits)) best = found;
+            }
         }
     }
-    
+    return best;
+}
+
+/**
+ * @brief Finds the first hidden subset of a size that removes pencil marks
+ * 
+ * Only the combinations of the digits with 1 to size positions in a unit
+ * are tried in it. The result is the same subset findHidden finds when
+ * it is called with every combination in order.
+ * 
+ * @param board to search through
+ * @param size number of digits in the subset
+ * @param units units to search as set bits, see ALL_UNITS
+ * @return subset the first subset, with no digits if there is none
+ */
+static subset firstHiddenSubset(Board &board, int size, std::uint32_t units) {
+    subset best = {0, 0};
+    auto combinations = getSubsetCombinations(size);
+    const auto &positions = board.getPositions();
+    for (auto unit = 0; unit < 27; unit++) {
+        if ((units & (1u << unit)) == 0) continue;
+        std::uint16_t few = 0;
+        for (auto digit = 0; digit < 9; digit++) {
+            int count = countBits(positions[unit][digit]);
+            if (count >= 1 && count <= size) few |= (1 << digit);
+        }
+        if (countBits(few) < size) continue;
+
+        for (std::size_t n = 0; n < combinations.second; n++) {
+            subset found = {combinations.first[n], unit};
+            if (found.order() >= best.order()) break;
+            if ((found.digits & few) != found.digits) continue;
+            std::uint16_t squares = 0;
+            for (std::uint16_t rest = found.digits; rest != 0; rest &= rest - 1) {
+                squares |= positions[unit][firstBit(rest)];
+            }
+            if (countBits(squares) != size) continue;
+
+            bool removes = false;
+            for (std::uint16_t rest = squares; rest != 0; rest &= rest - 1) {
+                int cell = Sudoku::UNIT_CELLS[unit][firstBit(rest)];
+                if ((board.getPencil(Sudoku::ROW_OF[cell], Sudoku::COL_OF[cell]) & ~found.digits) != 0) {
+                    removes = true;
+                }
+            }
+            if (removes) {
+                best = found;
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+static bool removeSubset(Board &board, const subset &found, bool naked, MoveList &moves) {
+    if (found.digits == 0) return false;
+    char i_min, i_max, j_min, j_max;
+    getUnitBounds(found.unit, i_min, i_max, j_min, j_max);
+    if (naked) {
+        return removedOccurrencesNaked(board, found.digits, i_min, i_max, j_min, j_max, moves);
+    }
+    return removedOccurrencesHidden(board, found.digits, i_min, i_max, j_min, j_max, moves);
+}
+
+/**
+ * @brief Gets the units a box based technique depends on for every box
+ * 
+ * That is the box itself and the rows and columns crossing it.
+ */
+static constexpr std::array<std::uint32_t, 9> makeBoxDependencies() {
+    std::array<std::uint32_t, 9> dependencies = {};
+    for (auto box = 0; box < 9; box++) {
+        for (auto cell : Sudoku::UNIT_CELLS[Sudoku::BOX_UNIT + box]) {
+            for (auto unit : Sudoku::CELL_UNITS[cell]) {
+                dependencies[box] |= (1u << unit);
+            }
+        }
+    }
+    return dependencies;
+}
+
+static constexpr auto BOX_DEPENDENCIES = makeBoxDependencies();
+
+HumanSolver::HumanSolver(Board &board) : board(board) {
+    seen = {};
+    nakedSingles = {};
+    hiddenSingles = {};
+    stale.fill(ALL_UNITS);
+}
+
+/**
+ * @brief Finds the units that changed since the last hint
+ * 
+ * Singles are updated for the squares that have or had a digit that moved
+ * in a changed unit, and the changed units are added to every tier.
+ */
+void HumanSolver::update() {
+    const auto &positions = board.getPositions();
+    std::uint32_t changed = 0;
+    for (auto unit = 0; unit < 27; unit++) {
+        for (auto digit = 0; digit < 9; digit++) {
+            std::uint16_t diff = positions[unit][digit] ^ seen[unit][digit];
+            if (diff == 0) continue;
+            changed |= (1u << unit);
+            std::uint16_t squares = positions[unit][digit] | seen[unit][digit];
+            for (auto pos = 0; pos < 9; pos++) {
+                if ((squares & (1 << pos)) == 0) continue;
+                int cell = Sudoku::UNIT_CELLS[unit][pos];
+                int row = Sudoku::ROW_OF[cell];
+                int col = Sudoku::COL_OF[cell];
+                updateHidden(row, col, digit);
+                // every square is in exactly one row, update its marks once
+                if (unit < Board::COL_UNIT && (diff & (1 << pos)) != 0) {
+                    updateNaked(row, col);
+                }
+            }
+        }
+    }
+    seen = positions;
+    for (auto &units : stale) {
+        units |= changed;
+    }
+}
+
+void HumanSolver::updateNaked(int row, int col) {
+    std::uint16_t marks = board.isEmpty(row, col) ? board.getPencil(row, col) : 0;
+    for (auto digit = 0; digit < 9; digit++) {
+        if (marks == (1 << digit)) {
+            nakedSingles[digit][row] |= (1 << col);
+        }
+        else {
+            nakedSingles[digit][row] &= ~(1 << col);
+        }
+    }
+}
+
+void HumanSolver::updateHidden(int row, int col, int digit) {
+    const auto &positions = board.getPositions();
+    std::uint16_t inRow = positions[Board::ROW_UNIT + row][digit];
+    hiddenSingles[digit][row] &= ~(1 << col);
+    if ((inRow & (1 << col)) == 0) return;
+    std::uint16_t inCol = positions[Board::COL_UNIT + col][digit];
+    std::uint16_t inBox = positions[Sudoku::CELL_UNITS[row * Sudoku::SIZE + col][2]][digit];
+    if (countBits(inBox) == 1 || countBits(inRow) == 1 || countBits(inCol) == 1) {
+        hiddenSingles[digit][row] |= (1 << col);
+    }
+}
+
+/**
+ * @brief Gets the first single in the order solveHuman looks for them
+ * 
+ * @param hint filled with the move and difficulty of the single
+ * @return true if there is a single
+ */
+bool HumanSolver::findSingle(Hint &hint) {
+    for (auto digit = 0; digit < 9; digit++) {
+        for (auto hidden = 0; hidden < 2; hidden++) {
+            const auto &singles = hidden ? hiddenSingles[digit] : nakedSingles[digit];
+            for (char row = 0; row < 9; row++) {
+                if (singles[row] == 0) continue;
+                char col = firstBit(singles[row]);
+                hint.moves.push_back({(char)(digit + START_CHAR), row, col, &Board::insert});
+                hint.difficulty = hidden ? 2 : 1;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Gets every naked single, or every hidden single if there are none
+ * 
+ * The singles can all be placed at once, every square only gets the
+ * first digit that is a single there.
+ * 
+ * @param hint filled with the moves and the difficulty of the singles
+ * @return true if there are any singles
+ */
+bool HumanSolver::findAllSingles(Hint &hint) {
+    for (auto hidden = 0; hidden < 2; hidden++) {
+        std::array<std::uint16_t, 9> taken = {};
+        for (auto digit = 0; digit < 9; digit++) {
+            const auto &singles = hidden ? hiddenSingles[digit] : nakedSingles[digit];
+            for (char row = 0; row < 9; row++) {
+                for (std::uint16_t cols = singles[row] & ~taken[row]; cols != 0; cols &= cols - 1) {
+                    char col = firstBit(cols);
+                    hint.moves.push_back({(char)(digit + START_CHAR), row, col, &Board::insert});
+                    taken[row] |= (1 << col);
+                }
+            }
+        }
+        if (!hint.moves.empty()) {
+            hint.difficulty = hidden ? 2 : 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Gets the boxes a box based tier has to search
+ * 
+ * A box has to be searched again if it, or a row or column crossing it,
+ * changed since the tier last found nothing.
+ */
+std::uint16_t HumanSolver::staleBoxes(tier t) const {
+    std::uint16_t boxes = 0;
+    for (auto box = 0; box < 9; box++) {
+        if ((stale[t] & BOX_DEPENDENCIES[box]) != 0) {
+            boxes |= (1 << box);
+        }
+    }
+    return boxes;
+}
+
+/**
+ * @brief Gets the number of squares in the units a tier searches
+ * 
+ * Squares in more than one of the units are counted once for each.
+ */
+std::uint64_t HumanSolver::searchedCells(tier t) const {
+    static_assert(TIERS + 1 == Profile::TECHNIQUES, "every tier is profiled after the singles");
+    switch (t) {
+        case POINTING:
+        case LOCKED:
+        return 9 * countBits(staleBoxes(t));
+        case DOUBLES:
+        case NAKED_TRIPLES:
+        case NAKED_QUADS:
+        case HIDDEN_TRIPLES:
+        case HIDDEN_QUADS:
+        return 9 * __builtin_popcount(stale[t]);
+        default:
+        return Sudoku::CELLS;
+    }
+}
+
+/**
+ * @brief Records if a tier found anything
+ * 
+ * A tier that found nothing only has to search the units that change
+ * from now on, one that found something has to search everything again.
+ * 
+ * @return hit
+ */
+bool HumanSolver::found(tier t, bool hit) {
+    if (Profile::ENABLED) {
+        std::uint64_t ns = timer.lap();
+        if (stale[t] != 0) {
+            Profile::record((Profile::technique)(t + 1), hit, ns, searchedCells(t));
+        }
+    }
+    stale[t] = hit ? ALL_UNITS : 0;
+    return hit;
+}
+
+/**
+ * @brief Gets the next hint for the board
+ * 
+ * @param allSingles get every naked single, or every hidden single, at once
+ * @return Hint the same hint solveHuman gives for the board
+ */
+Hint HumanSolver::nextHint(bool allSingles) {
+    Hint hint;
+    hint.difficulty = 0;
+
+    if (board.isWon()){
+        return hint;
+    }
+
+    timer.start();
+    update();
+    bool single = allSingles ? findAllSingles(hint) : findSingle(hint);
+    Profile::record(Profile::SINGLES, single, timer.lap(), Sudoku::CELLS);
+    if (single) {
+        return hint;
+    }
+
+    std::uint16_t boxes = staleBoxes(POINTING);
     for (char i = 0; i < 9; i += 3) {
         for (char j = 0; j < 9; j += 3) {
+            if ((boxes & (1 << (i + j / 3))) == 0) continue;
             if (findPointingBox(board, i, j, hint.moves)) {
-                std::stringstream hint_1_stream;
-                std::stringstream hint_2_stream;
-                hint_1_stream << "Look closer at the digit " << hint.moves[0].val;
-                hint_2_stream << "The digit " << hint.moves[0].val << " forms a pointing box.";
-                hint.hint1 = hint_1_stream.str();
-                hint.hint2 = hint_2_stream.str();
+                found(POINTING, true);
                 hint.difficulty = 3;
                 return hint;
             }
         }
     }
+    found(POINTING, false);
 
-    for (auto num : all_doubles) {
-        if (findNaked(board, num, hint.moves)) {
-            hint.hint1 = "Look for a naked double";
-            hint.hint2 = getGenericHint(hint.moves);
-            hint.difficulty = 4;
-            return hint;
-        }
-        if (findHidden(board, num, hint.moves)) {
-            hint.hint1 = "Look for a hidden double";
-            hint.hint2 = getGenericHint(hint.moves);
-            hint.difficulty = 5;
-            return hint;
-        }
+    // A naked pair comes before a hidden pair of the same digits
+    subset naked = firstNakedSubset(board, 2, stale[DOUBLES]);
+    subset hidden = firstHiddenSubset(board, 2, stale[DOUBLES]);
+    if (naked.digits != 0 && (hidden.digits == 0 || COMBO_INDEX[naked.digits] <= COMBO_INDEX[hidden.digits])) {
+        removeSubset(board, naked, true, hint.moves);
+        found(DOUBLES, true);
+        hint.difficulty = 4;
+        return hint;
+    }
+    if (found(DOUBLES, removeSubset(board, hidden, false, hint.moves))) {
+        hint.difficulty = 5;
+        return hint;
     }
 
-    if (findLockedCandidates(board, hint.moves)) {
-        std::stringstream hint_1_stream;
-        std::stringstream hint_2_stream;
-        hint.hint1 = "Look for locked candidates";
-        hint.hint2 = getGenericHint(hint.moves);
+    if (found(LOCKED, findLockedCandidates(board, hint.moves, staleBoxes(LOCKED)))) {
         hint.difficulty = 6;
         return hint;
     }
-    for (auto &triple : all_triples) {
-        if (findNaked(board, triple, hint.moves)) {
-            //return true;
-            hint.hint1 = "Look for a naked triple";
-            hint.hint2 = getGenericHint(hint.moves);
-            hint.difficulty = 7;
-            return hint;
-        }
+    if (found(NAKED_TRIPLES, findNakedSubset(board, 3, hint.moves, stale[NAKED_TRIPLES]))) {
+        hint.difficulty = 7;
+        return hint;
     }
-    for (auto &quad : all_quads) {
-        if (findNaked(board, quad, hint.moves)) {
-            //return true;
-            hint.hint1 = "Look for a naked quadtruple";
-            hint.hint2 = getGenericHint(hint.moves);
-            hint.difficulty = 8;
-            return hint;
-        }
+    if (found(NAKED_QUADS, findNakedSubset(board, 4, hint.moves, stale[NAKED_QUADS]))) {
+        hint.difficulty = 8;
+        return hint;
     }
-    for (auto &triple : all_triples) {
-        if (findHidden(board, triple, hint.moves)) {
-            //return true;
-            hint.hint1 = "Look for a hidden triple";
-            hint.hint2 = getGenericHint(hint.moves);
-            hint.difficulty = 9;
-            return hint;
-        }
+    if (found(HIDDEN_TRIPLES, findHiddenSubset(board, 3, hint.moves, stale[HIDDEN_TRIPLES]))) {
+        hint.difficulty = 9;
+        return hint;
     }
-    for (auto &quad : all_quads) {
-        if (findHidden(board, quad, hint.moves)) {
-            //return true;
-            hint.hint1 = "Look for a hidden quadruple";
-            hint.hint2 = getGenericHint(hint.moves);
-            hint.difficulty = 10;
-            return hint;
-        }
+    if (found(HIDDEN_QUADS, findHiddenSubset(board, 4, hint.moves, stale[HIDDEN_QUADS]))) {
+        hint.difficulty = 10;
+        return hint;
     }
+
+    // The remaining techniques look at the whole board, they are only
+    // skipped when nothing changed since they last found nothing
     Move singleMove;
-    if (findBug(board, &singleMove)) {
+    if (stale[BUG] != 0 && found(BUG, findBug(board, &singleMove))) {
         hint.moves.push_back(singleMove);
-        hint.hint1 = "Look for a bug";
-        std::stringstream hintStream;
-        hintStream << "The digit " << hint.moves[0].val << "can only go in row " << (char)(hint.moves[0].row + START_CHAR) << "and in column " << (char)(hint.moves[0].col + START_CHAR);
         hint.difficulty = 11;
         return hint;
     }
-    for (auto &doub : all_doubles) {
-        if (findChainOfPairs(board, doub, hint.moves)) {
-            hint.hint1 = "Look for a chain of pairs";
-            hint.hint2 = getGenericHint(hint.moves);
-            hint.difficulty = 12;
-            return hint;
+    if (stale[CHAIN] != 0) {
+        ChainGraph chains(board);
+        for (auto &doub : all_doubles) {
+            if (chains.findChain(board, doub, hint.moves)) {
+                found(CHAIN, true);
+                hint.difficulty = 12;
+                return hint;
+            }
         }
     }
+    found(CHAIN, false);
     for (auto &doub : all_doubles) {
+        if (stale[RECTANGLE] == 0) break;
         if (findUniqueRectangle(board, doub, hint.moves)) {
-            //return true;
-            hint.hint1 = "Look for a unique rectangle";
-            hint.hint2 = getGenericHint(hint.moves);
+            found(RECTANGLE, true);
             hint.difficulty = 13;
             return hint;
         }
     }
-    for (auto &single : all_singles) {
-        if (findXwing(board, single, hint.moves)) {
-            //return true;
-            hint.hint1 = "Look for an X-wing";
-            std::stringstream hintstr;
-            hintstr << "Look closer at the digit ";
-            hintstr << hint.moves[0].val;
-            hint.hint2 = hintstr.str();
-            hint.difficulty = 14;
-            return hint;
+    found(RECTANGLE, false);
+    // X-wings, swordfish and jellyfish have 2, 3 and 4 base sets, the
+    // difficulties of the bigger two come after the unsolved one
+    for (auto size = 2; size <= 4; size++) {
+        tier t = (tier)(XWING + size - 2);
+        for (auto &single : all_singles) {
+            if (stale[t] == 0) break;
+            if (findFish(board, single, size, hint.moves)) {
+                found(t, true);
+                hint.difficulty = size == 2 ? 14 : 13 + size;
+                return hint;
+            }
         }
+        found(t, false);
     }
 
-    hint.hint1 = "Unable to give any hints";
-    hint.hint2 = "This is out of my league";
-    hint.difficulty = 15;
+    hint.difficulty = UNSOLVED_DIFFICULTY;
     return hint;
 }
 
+/**
+ * @brief Solves the board with human techniques until solved or stuck
+ * 
+ * The board should be pencil marked before it is graded. Placing all
+ * singles at once reaches the same boards whenever the singles run out,
+ * so only the choice between naked and hidden singles can differ: a
+ * board that naked singles solve gets 1, one at a time it can get 2.
+ * 
+ * @param allSingles place every single found in one step
+ * @return Grade hardest technique needed, moves made and if the board got solved
+ */
+Grade HumanSolver::grade(bool allSingles) {
+    Grade grade = {};
+    Hint hint = nextHint(allSingles);
+    while (hint.moves.size() > 0) {
+        if (hint.difficulty > grade.difficulty) {
+            grade.difficulty = hint.difficulty;
+        }
+        for (auto &move : hint.moves) {
+            move(&board);
+            grade.moves++;
+        }
+        hint = nextHint(allSingles);
+    }
+    // a full board without a digit twice in a unit is solved, no need to
+    // solve the puzzle to compare with
+    grade.solved = board.isComplete();
+    if (!grade.solved) {
+        grade.difficulty = hint.difficulty;
+    }
+    return grade;
+}
+
+// First line of the hint for each difficulty
+static const char *const HINT_TITLES[] = {
+    "Board is solved!",
+    "",
+    "",
+    "",
+    "Look for a naked double",
+    "Look for a hidden double",
+    "Look for locked candidates",
+    "Look for a naked triple",
+    "Look for a naked quadtruple",
+    "Look for a hidden triple",
+    "Look for a hidden quadruple",
+    "Look for a bug",
+    "Look for a chain of pairs",
+    "Look for a unique rectangle",
+    "Look for an X-wing",
+    "Unable to give any hints",
+    "Look for a swordfish",
+    "Look for a jellyfish",
+};
+
+/**
+ * @brief Gets the first line of the hint, saying what to look for
+ */
+std::string Hint::hint1() const {
+    if (difficulty >= 1 && difficulty <= 3) {
+        std::stringstream hintStream;
+        hintStream << "Look closer at the digit " << moves[0].val;
+        return hintStream.str();
+    }
+    return HINT_TITLES[difficulty];
+}
+
+/**
+ * @brief Gets the second line of the hint, saying where to look
+ */
+std::string Hint::hint2() const {
+    std::stringstream hintStream;
+    switch (difficulty) {
+        case 0:
+        return "Board is solved!";
+        case 1:
+        hintStream << "row " << (char)(moves[0].row + START_CHAR) << " column " << (char)(moves[0].col + START_CHAR) << " can only be " << moves[0].val;
+        return hintStream.str();
+        case 2:
+        hintStream << "row " << (char)(moves[0].row + START_CHAR) << " column " << (char)(moves[0].col + START_CHAR) << " is the only possible location for " << moves[0].val;
+        return hintStream.str();
+        case 3:
+        hintStream << "The digit " << moves[0].val << " forms a pointing box.";
+        return hintStream.str();
+        case 11:
+        hintStream << "The digit " << moves[0].val << " can only go in row " << (char)(moves[0].row + START_CHAR) << " and in column " << (char)(moves[0].col + START_CHAR);
+        return hintStream.str();
+        case UNSOLVED_DIFFICULTY:
+        return "This is out of my league";
+    }
+    return getGenericHint(moves);
+}
+
+Hint solveHuman(Board &board) {
+    HumanSolver solver(board);
+    return solver.nextHint();
+}
+
+/**
+ * @brief Solves the board with human techniques until solved or stuck
+ * 
+ * The board should be pencil marked before it is graded.
+ * 
+ * @param board to solve, moves are applied to it
+ * @param allSingles place every single found in one step, see HumanSolver::grade
+ * @return Grade hardest technique needed, moves made and if the board got solved
+ */
+Grade gradeHuman(Board &board, bool allSingles) {
+    HumanSolver solver(board);
+    return solver.grade(allSingles);
+}
+
 /**
  * @brief finds any naked singles in the board
  * 
@@ -327,8 +815,8 @@ bool findNakedSingles(Board &board, const std::uint16_t single, Move *move) {
                 //board->insert(getSetBits(single)[0] + START_CHAR, i ,j);
                 (*move).col = j;
                 (*move).row = i;
-                (*move).val = getSetBits(single)[0] + START_CHAR;
-                (*move).move = &SimpleBoard::insert;
+                (*move).val = firstBit(single) + START_CHAR;
+                (*move).move = &Board::insert;
                 return true;
             }
         }
@@ -346,20 +834,19 @@ bool findNakedSingles(Board &board, const std::uint16_t single, Move *move) {
  * @return false otherwise
  */
 bool findHiddenSingles(Board &board, const std::uint16_t single, Move *move) {
+    const char num = firstBit(single);
+    const auto &positions = board.getPositions();
     for (auto i = 0; i < 9; i++) {
+        std::uint16_t row = positions[Board::ROW_UNIT + i][num];
         for (auto j = 0; j < 9; j++) {
-            if (!board.isEmpty(i ,j)) continue;
-            if ((board.getPencil(i, j) & single) == 0) continue;
-            auto i_box = (i / 3) * 3;
-            auto j_box = (j / 3) * 3;
-            std::uint16_t trash;
-            if ((countOccurrencesHidden(board, single, i_box, i_box + 3, j_box, j_box + 3, trash, trash) == 1)
-                || (countOccurrencesHidden(board, single, i, i + 1, 0, 9, trash, trash) == 1)
-                || (countOccurrencesHidden(board, single, 0, 9, j, j + 1, trash, trash) == 1)) {
+            if ((row & (1 << j)) == 0) continue;
+            std::uint16_t box = positions[Sudoku::CELL_UNITS[i * Sudoku::SIZE + j][2]][num];
+            std::uint16_t col = positions[Board::COL_UNIT + j][num];
+            if (countBits(box) == 1 || countBits(row) == 1 || countBits(col) == 1) {
                 (*move).col = j;
                 (*move).row = i;
-                (*move).val = getSetBits(single)[0] + START_CHAR;
-                (*move).move = &SimpleBoard::insert;
+                (*move).val = num + START_CHAR;
+                (*move).move = &Board::insert;
                 return true;
             }
         }
@@ -367,13 +854,24 @@ bool findHiddenSingles(Board &board, const std::uint16_t single, Move *move) {
     return false;
 }
 
-bool findNaked(Board &board, const std::uint16_t num, std::vector<Move> &moves) {
+/**
+ * @brief Finds naked subsets
+ * 
+ * @param board to search through
+ * @param num digits of the subset as set bits
+ * @param moves vector that gets populated with found moves
+ * @param units units to search as set bits, see ALL_UNITS
+ * @return true if pencil marks can be removed
+ * @return false otherwise
+ */
+bool findNaked(Board &board, const std::uint16_t num, MoveList &moves, std::uint32_t units) {
     std::uint16_t trash;
     if (num == 0) return false;
     const char matcher = countBits(num);
     // finding in box
     for (auto i_box = 0; i_box < 9; i_box += 3) {
         for (auto j_box = 0; j_box < 9; j_box += 3) {
+            if ((units & (1u << (Board::BOX_UNIT + i_box + j_box / 3))) == 0) continue;
             auto count = countOccurrencesNaked(board, num, i_box, i_box + 3, j_box, j_box + 3, trash, trash);
             if (count != matcher) continue;
             if (removedOccurrencesNaked(board, num, i_box, i_box + 3, j_box, j_box + 3, moves)) {
@@ -384,13 +882,14 @@ bool findNaked(Board &board, const std::uint16_t num, std::vector<Move> &moves)
 
     // rows and cols
     for (auto i = 0; i < 9; i++) {
-        auto count =  countOccurrencesNaked(board, num, i, i+1, 0, 9, trash, trash);
-        if (count == matcher) {
-            if (removedOccurrencesNaked(board, num, i, i+1, 0, 9, moves)) {
+        if ((units & (1u << (Board::ROW_UNIT + i))) != 0) {
+            auto count =  countOccurrencesNaked(board, num, i, i+1, 0, 9, trash, trash);
+            if (count == matcher && removedOccurrencesNaked(board, num, i, i+1, 0, 9, moves)) {
                 return true;
             }
         }
-        count = countOccurrencesNaked(board, num, 0, 9, i, i+1, trash, trash);
+        if ((units & (1u << (Board::COL_UNIT + i))) == 0) continue;
+        auto count = countOccurrencesNaked(board, num, 0, 9, i, i+1, trash, trash);
         if (count == matcher) {
             if (removedOccurrencesNaked(board, num, 0, 9, i, i+1, moves)) {
                 return true;
@@ -401,14 +900,25 @@ bool findNaked(Board &board, const std::uint16_t num, std::vector<Move> &moves)
 }
 
 
-bool findHidden(Board &board, const std::uint16_t num, std::vector<Move> &moves) {
+/**
+ * @brief Finds hidden subsets
+ * 
+ * @param board to search through
+ * @param num digits of the subset as set bits
+ * @param moves vector that gets populated with found moves
+ * @param units units to search as set bits, see ALL_UNITS
+ * @return true if pencil marks can be removed
+ * @return false otherwise
+ */
+bool findHidden(Board &board, const std::uint16_t num, MoveList &moves, std::uint32_t units) {
     if (num == 0) return false;
     const char matcher = countBits(num);
     std::uint16_t trash;
     // finding in box
     for (auto i_box = 0; i_box < 9; i_box += 3) {
         for (auto j_box = 0; j_box < 9; j_box += 3) {
-            char count = countOccurrencesHidden(board, num, i_box, i_box + 3, j_box, j_box + 3, trash, trash);
+            if ((units & (1u << (Board::BOX_UNIT + i_box + j_box / 3))) == 0) continue;
+            char count = countOccurrencesHidden(board, num, Board::BOX_UNIT + i_box + j_box / 3, trash, trash);
             if (count != matcher) continue;
             if (removedOccurrencesHidden(board, num, i_box, i_box + 3, j_box, j_box + 3, moves)) {
                 return true;
@@ -418,13 +928,14 @@ bool findHidden(Board &board, const std::uint16_t num, std::vector<Move> &moves)
 
     // finding in rows and cols
     for (auto i = 0; i < 9; i++) {
-        char count = countOccurrencesHidden(board, num, i, i+1, 0, 9, trash, trash);
-        if (count == matcher) {
-            if (removedOccurrencesHidden(board, num, i, i+1, 0, 9, moves)) {
+        if ((units & (1u << (Board::ROW_UNIT + i))) != 0) {
+            char count = countOccurrencesHidden(board, num, Board::ROW_UNIT + i, trash, trash);
+            if (count == matcher && removedOccurrencesHidden(board, num, i, i+1, 0, 9, moves)) {
                 return true;
             }
         }
-        count = countOccurrencesHidden(board, num, 0, 9, i, i+1, trash, trash);
+        if ((units & (1u << (Board::COL_UNIT + i))) == 0) continue;
+        char count = countOccurrencesHidden(board, num, Board::COL_UNIT + i, trash, trash);
         if (count == matcher) {
             if (removedOccurrencesHidden(board, num, 0, 9, i, i+1, moves)) {
                 return true;
@@ -434,12 +945,46 @@ bool findHidden(Board &board, const std::uint16_t num, std::vector<Move> &moves)
     return false;
 }
 
-static bool removeMarks_i_box(Board &board, char val, char i, char j_box, std::vector<Move> &moves) {
-    auto pencil = board.getPencilMarks();
+/**
+ * @brief Finds the first naked subset of a size, in the order of the digits
+ * 
+ * Gives the same moves as calling findNaked with every combination of
+ * size digits in order until one is found.
+ * 
+ * @param board to search through
+ * @param size number of digits in the subset, 2 to 4
+ * @param moves vector that gets populated with found moves
+ * @param units units to search as set bits, see ALL_UNITS
+ * @return true if pencil marks can be removed
+ * @return false otherwise
+ */
+bool findNakedSubset(Board &board, int size, MoveList &moves, std::uint32_t units) {
+    return removeSubset(board, firstNakedSubset(board, size, units), true, moves);
+}
+
+/**
+ * @brief Finds the first hidden subset of a size, in the order of the digits
+ * 
+ * Gives the same moves as calling findHidden with every combination of
+ * size digits in order until one is found.
+ * 
+ * @param board to search through
+ * @param size number of digits in the subset, 2 to 4
+ * @param moves vector that gets populated with found moves
+ * @param units units to search as set bits, see ALL_UNITS
+ * @return true if pencil marks can be removed
+ * @return false otherwise
+ */
+bool findHiddenSubset(Board &board, int size, MoveList &moves, std::uint32_t units) {
+    return removeSubset(board, firstHiddenSubset(board, size, units), false, moves);
+}
+
+static bool removeMarks_i_box(Board &board, char val, char i, char j_box, MoveList &moves) {
+    const auto &pencil = board.getPencilMarks();
     for (char idx = 0; idx < 9; idx++) {
         if (((idx / 3) * 3) == j_box) continue; // same box as pointers
         if (!board.isEmpty(i, idx)) continue;
-        if ((pencil[i][idx] & (1 << val)) != 0) {
+        if ((pencil[i * Sudoku::SIZE + idx] & (1 << val)) != 0) {
             //board->pencil(val + START_CHAR, i, idx);
             Move move = {(char)(val + START_CHAR), i, idx, &Board::pencil};
             moves.push_back(move);
@@ -449,12 +994,12 @@ static bool removeMarks_i_box(Board &board, char val, char i, char j_box, std::v
     return false;
 }
 
-static bool removeMarks_j_box(Board &board, char val, char j, char i_box, std::vector<Move> &moves) {
-    auto pencil = board.getPencilMarks();
+static bool removeMarks_j_box(Board &board, char val, char j, char i_box, MoveList &moves) {
+    const auto &pencil = board.getPencilMarks();
     for (char idx = 0; idx < 9; idx++) {
         if (((idx / 3) * 3) == i_box) continue;
         if (!board.isEmpty(idx, j)) continue;
-        if ((pencil[idx][j] & (1 << val)) != 0) {
+        if ((pencil[idx * Sudoku::SIZE + j] & (1 << val)) != 0) {
             //board->pencil(val + START_CHAR, idx, j);
             Move move = {(char)(val + START_CHAR), idx, j, &Board::pencil};
             moves.push_back(move);
@@ -464,15 +1009,15 @@ static bool removeMarks_j_box(Board &board, char val, char j, char i_box, std::v
     return false;
 }
 
-bool findPointingBox(Board &board, char i_start, char j_start, std::vector<Move> &moves) {
+bool findPointingBox(Board &board, char i_start, char j_start, MoveList &moves) {
     char counts[9] = {};
     bool indexes[9][3][3] = {false};
-    auto marks = board.getPencilMarks();
+    const auto &marks = board.getPencilMarks();
     for (auto i = i_start; i < i_start + 3; i++) {
         for (auto j = j_start; j < j_start + 3; j++) {
             if (!board.isEmpty(i, j)) continue;
             for (unsigned char num = 0; num < 9; num++) {
-                if ((marks[i][j] & (1 << num)) == 0) continue;
+                if ((marks[i * Sudoku::SIZE + j] & (1 << num)) == 0) continue;
                 counts[num]++;
                 indexes[num][i - i_start][j - j_start] = true;
             }
@@ -518,12 +1063,12 @@ bool findPointingBox(Board &board, char i_start, char j_start, std::vector<Move>
 }
 
 static bool existsOnlyInBox(Board &board, char box_i, char box_j, char i_min, char i_max, char j_min, char j_max, char num) {
-    auto pencils = board.getPencilMarks();
+    const auto &pencils = board.getPencilMarks();
     for (auto i = i_min; i < i_max; i++) {
         for (auto j = j_min; j < j_max; j++) {
             if (!board.isEmpty(i, j)) continue;
             if (((i / 3) * 3) == box_i && ((j / 3) * 3) == box_j) continue;
-            if ((pencils[i][j] & (1 << num)) != 0) {
+            if ((pencils[i * Sudoku::SIZE + j] & (1 << num)) != 0) {
                 return false;
             }
         }
@@ -531,14 +1076,14 @@ static bool existsOnlyInBox(Board &board, char box_i, char box_j, char i_min, ch
     return true;
 }
 
-static bool removedLockedIFromBox(Board &board, char box_i, char box_j, char locked_i, char num, std::vector<Move> &moves) {
-    auto pencils = board.getPencilMarks();
+static bool removedLockedIFromBox(Board &board, char box_i, char box_j, char locked_i, char num, MoveList &moves) {
+    const auto &pencils = board.getPencilMarks();
     bool ret = false;
     for (auto i = box_i; i < box_i + 3; i++) {
         for (auto j = box_j; j < box_j + 3; j++) {
             if (!board.isEmpty(i, j)) continue;
             if (i == locked_i) continue;
-            if ((pencils[i][j] & (1 << num)) != 0) {
+            if ((pencils[i * Sudoku::SIZE + j] & (1 << num)) != 0) {
                 //board->pencil(num + START_CHAR, i, j);
                 Move move = {(char)(num + START_CHAR), i, j, &Board::pencil};
                 moves.push_back(move);
@@ -549,14 +1094,14 @@ static bool removedLockedIFromBox(Board &board, char box_i, char box_j, char loc
     return ret;
 }
 
-static bool removedLockedJFromBox(Board &board, char box_i, char box_j, char locked_j, char num, std::vector<Move> &moves) {
-    auto pencils = board.getPencilMarks();
+static bool removedLockedJFromBox(Board &board, char box_i, char box_j, char locked_j, char num, MoveList &moves) {
+    const auto &pencils = board.getPencilMarks();
     bool ret = false;
     for (auto i = box_i; i < box_i + 3; i++) {
         for (auto j = box_j; j < box_j + 3; j++) {
             if (!board.isEmpty(i, j)) continue;
             if (j == locked_j) continue;
-            if ((pencils[i][j] & (1 << num)) != 0) {
+            if ((pencils[i * Sudoku::SIZE + j] & (1 << num)) != 0) {
                 //board->pencil(num + START_CHAR, i, j);
                 Move move = {(char)(num + START_CHAR), i, j, &Board::pencil};
                 moves.push_back(move);
@@ -567,15 +1112,25 @@ static bool removedLockedJFromBox(Board &board, char box_i, char box_j, char loc
     return ret;
 }
 
-bool findLockedCandidates(Board &board, std::vector<Move> &moves) {
-    auto pencils = board.getPencilMarks();
+/**
+ * @brief Finds digits locked to a row or column inside a box
+ * 
+ * @param board to search through
+ * @param moves vector that gets populated with found moves
+ * @param boxes boxes to search as set bits, see ALL_BOXES
+ * @return true if pencil marks can be removed
+ * @return false otherwise
+ */
+bool findLockedCandidates(Board &board, MoveList &moves, std::uint16_t boxes) {
+    const auto &pencils = board.getPencilMarks();
     for (auto box_i = 0; box_i < 9; box_i += 3) {
         for (auto box_j = 0; box_j < 9; box_j += 3) {
+            if ((boxes & (1 << (box_i + box_j / 3))) == 0) continue;
             for (auto i = box_i; i < box_i + 3; i++) {
                 for (auto j = box_j; j < box_j + 3; j++) {
                     if (!board.isEmpty(i, j)) continue;
                     for (unsigned char num = 0; num < 9; num++) {
-                        if ((pencils[i][j] & (1 << num)) == 0) continue;
+                        if ((pencils[i * Sudoku::SIZE + j] & (1 << num)) == 0) continue;
                         if (existsOnlyInBox(board, box_i, box_j, i, i+1, 0, 9, num)) {
                             if (removedLockedIFromBox(board, box_i, box_j, i, num, moves)) {
                                 return true;
@@ -599,36 +1154,35 @@ bool findBug(Board &board, Move *move) {
     int col = 0xFF;
     int row = 0xFF;
     std::uint16_t bits = 0;
-    for (auto i = 0; i < 9; i++) {
-        for (auto j = 0; j < 9; j++) {
-            if (!board.isEmpty(i, j))continue;
-            auto pencils = board.getPencil(i, j);
-            auto count = countBits(pencils);
-            if (count > 3) return false;
-            if (count == 3) {
-                numb_of_threes++;
-                col = i;
-                row = j;
-                bits = pencils;
-            }
-        }
+    // only squares with three or more marks matter
+    Sudoku::cellSet many = Candidates::withMoreThan(board.getPencilMarks().data(), 2);
+    for (; many.any(); many.remove(many.first())) {
+        int i = Sudoku::ROW_OF[many.first()];
+        int j = Sudoku::COL_OF[many.first()];
+        if (!board.isEmpty(i, j))continue;
+        auto pencils = board.getPencil(i, j);
+        if (countBits(pencils) > 3) return false;
+        numb_of_threes++;
+        col = i;
+        row = j;
+        bits = pencils;
     }
     if (numb_of_threes != 1) return false;
 
-    auto numbs = getSetBits(bits);
     int col_box = (col / 3) * 3;
     int row_box = (row / 3) * 3;
-    for (auto num: numbs) {
+    for (; bits != 0; bits &= bits - 1) {
+        char num = firstBit(bits);
         std::uint16_t num_bits = (1 << num);
         std::uint16_t trash;
-        if ((countOccurrencesHidden(board, num_bits, col, col + 1, 0, 9, trash, trash) == 3)
-          && (countOccurrencesHidden(board, num_bits, 0, 9, row, row + 1, trash, trash) == 3)
-          && (countOccurrencesHidden(board, num_bits, col_box, col_box + 3, row_box, row_box + 3, trash, trash)) == 3) {
+        if ((countOccurrencesHidden(board, num_bits, Board::ROW_UNIT + col, trash, trash) == 3)
+          && (countOccurrencesHidden(board, num_bits, Board::COL_UNIT + row, trash, trash) == 3)
+          && (countOccurrencesHidden(board, num_bits, Board::BOX_UNIT + col_box + row_box / 3, trash, trash)) == 3) {
             //board->insert(num + START_CHAR, col, row);
             (*move).col = row;
             (*move).row = col;
             (*move).val = num + START_CHAR;
-            (*move).move = &SimpleBoard::insert;
+            (*move).move = &Board::insert;
             return true;
         }
     }
@@ -636,48 +1190,28 @@ bool findBug(Board &board, Move *move) {
 }
 
 /**
- * @brief Gets the indexes of the positions in the array matching curr
+ * @brief remove pencils marks found by a fish in rows
  * 
- * The matching indexes bits are set in the return value
+ * This function gets called if a fish is found with rows as the base sets
  * 
- * @param positions array containing the positions of the value being searched for in row/box
- * @param curr the current indexes to match with
- * @return the indexes in positions that match with curr as set bits in a 16bit integer 
- */
-static std::uint16_t getEqualWingIndexes(std::array<std::uint16_t, 9> positions, std::uint16_t curr) {
-    std::uint16_t indexes = 0;
-    int index = 0;
-    for (auto &pos : positions) {
-        if (pos == curr) {
-            indexes |= (1 << index);
-        }
-        index++;
-    }
-    return indexes;
-}
-
-/**
- * @brief remove pencils marks found by X-wing in rows
- * 
- * This function gets called if there are matching X-wings found in rows
- * 
- * @param board that the X-wing was found in
- * @param num that matches the X-wing. Num is the set bit
- * @param i_indexes Row indexes that the X-wing was found on
- * @param j_indexes Column indexes that the X-wing was found on
+ * @param board that the fish was found in
+ * @param num that matches the fish. Num is the set bit
+ * @param i_indexes Row indexes that the fish was found on
+ * @param j_indexes Column indexes that the fish covers
  * @param moves Vector that gets populated with the correct moves
  * @return true when correct moves have been found
  * @return false otherwise
  */
-static bool removeXwingByRows(Board &board, const std::uint16_t num, std::uint16_t i_indexes, std::uint16_t j_indexes, std::vector<Move> &moves) {
+static bool removeFishByRows(Board &board, const std::uint16_t num, std::uint16_t i_indexes, std::uint16_t j_indexes, MoveList &moves) {
     bool ret = false;
     for (char i = 0; i < 9; i++) {
         if ((i_indexes & (1 << i)) != 0) continue;
-        for (char j : getSetBits(j_indexes)) {
+        for (std::uint16_t cols = j_indexes; cols != 0; cols &= cols - 1) {
+            char j = firstBit(cols);
             if (!board.isEmpty(i, j)) continue;
-            auto marks = board.getPencil(i, j) & num;
-            if (marks == 0) continue;
-            for (auto unset : getSetBits(marks)) {
+            std::uint16_t marks = board.getPencil(i, j) & num;
+            for (; marks != 0; marks &= marks - 1) {
+                char unset = firstBit(marks);
                 Move move = {(char)(unset + START_CHAR), i, j, &Board::pencil};
                 moves.push_back(move);
                 ret = true;
@@ -688,27 +1222,28 @@ static bool removeXwingByRows(Board &board, const std::uint16_t num, std::uint16
 }
 
 /**
- * @brief Adds moves to the vector that are found by the X-Wing
+ * @brief Adds moves to the vector that are found by the fish
  * 
- * This function gets called if there are matching x-wings found in columns.
+ * This function gets called if a fish is found with columns as the base sets
  * 
- * @param board that the X-wing has been found in
- * @param num that matches the X-wing. Num is the set bit
- * @param i_indexes row indexes where the x-wing is located
- * @param j_indexes col indexes where the x-wing is located
+ * @param board that the fish has been found in
+ * @param num that matches the fish. Num is the set bit
+ * @param i_indexes row indexes that the fish covers
+ * @param j_indexes col indexes where the fish is located
  * @param moves vector that found moves gets put into
  * @return true if found any pencil marks to remove
  * @return false otherwise
  */
-static bool removeXwingByCols(Board &board, const std::uint16_t num, std::uint16_t i_indexes, std::uint16_t j_indexes, std::vector<Move> &moves) {
+static bool removeFishByCols(Board &board, const std::uint16_t num, std::uint16_t i_indexes, std::uint16_t j_indexes, MoveList &moves) {
     bool ret = false;
-    for (char i : getSetBits(i_indexes)) {
+    for (std::uint16_t rows = i_indexes; rows != 0; rows &= rows - 1) {
+        char i = firstBit(rows);
         for (char j = 0; j < 9; j++) {
-            if ((j_indexes & (1 << j)) != 0) continue; // same position as x-wing
+            if ((j_indexes & (1 << j)) != 0) continue; // same position as the fish
             if (!board.isEmpty(i, j)) continue;
-            auto marks = board.getPencil(i, j) & num;
-            if (marks == 0) continue;
-            for (auto unset : getSetBits(marks)) {
+            std::uint16_t marks = board.getPencil(i, j) & num;
+            for (; marks != 0; marks &= marks - 1) {
+                char unset = firstBit(marks);
                 Move move = {(char)(unset + START_CHAR), i, j, &Board::pencil};
                 moves.push_back(move);
                 ret = true;
@@ -719,43 +1254,89 @@ static bool removeXwingByCols(Board &board, const std::uint16_t num, std::uint16
 }
 
 /**
- * @brief Looks for xwings in the board
+ * @brief Gets the base sets to try for a fish of the given size
+ * 
+ * @param size number of rows or columns in the fish, 2 to 4
+ * @return every combination of size indexes as set bits
+ */
+static std::pair<const std::uint16_t *, std::size_t> getBaseSets(int size) {
+    switch (size) {
+        case 2:
+        return {all_doubles.data(), all_doubles.size()};
+        case 3:
+        return {all_triples.data(), all_triples.size()};
+        case 4:
+        return {all_quads.data(), all_quads.size()};
+    }
+    return {nullptr, 0};
+}
+
+/**
+ * @brief Looks for X-wings, swordfish and jellyfish in the board
+ * 
+ * Every base set of the size whose positions cover as many units is a
+ * fish, the first one that removes any pencil marks is returned. Rows are
+ * tried as the base sets before columns.
  * 
  * @param board to look through
- * @param num to match with the x-wing
+ * @param num to match with the fish
+ * @param size 2 for X-wings, 3 for swordfish and 4 for jellyfish
  * @param moves vector that gets filled with the correct moves, if any
- * @return true  if found any x-wings
+ * @return true if found any fish
  * @return false otherwise
  */
-bool findXwing(Board &board, const std::uint16_t num, std::vector<Move> &moves) {
+bool findFish(Board &board, const std::uint16_t num, int size, MoveList &moves) {
+    // columns of the digit in every row and rows of the digit in every column
+    const char digit = firstBit(num);
     std::array<std::uint16_t, 9> positions[2];
     for (auto i = 0; i < 9; i++) {
-        std::uint16_t seen_j, seen_i, trash;
-        seen_j = seen_i = 0;
-        countOccurrencesHidden(board, num, i, i+1, 0, 9, trash, seen_j);
-        positions[0][i] = seen_j;
-
-        countOccurrencesHidden(board, num, 0, 9, i, i+1, seen_i, trash);
-        positions[1][i] = seen_i;
+        positions[0][i] = board.getPositions(Board::ROW_UNIT + i, digit);
+        positions[1][i] = board.getPositions(Board::COL_UNIT + i, digit);
     }
-    for (auto i = 0; i < 9; i++) {
-        // indexes are columns where we should remove
-        std::uint16_t indexes = getEqualWingIndexes(positions[0], positions[0][i]);
-        if (countBits(indexes) != countBits(positions[0][i])) continue;
-        if (removeXwingByRows(board, num, indexes, positions[0][i], moves)) {
-            return true;
+
+    std::uint16_t candidates[2] = {};
+    for (auto k = 0; k < 2; k++) {
+        for (auto i = 0; i < 9; i++) {
+            int count = countBits(positions[k][i]);
+            if (count >= 2 && count <= size) candidates[k] |= (1 << i);
         }
     }
-    for (auto i = 0; i < 9; i++) {
-        std::uint16_t indexes = getEqualWingIndexes(positions[1], positions[1][i]);
-        if (countBits(indexes) != countBits(positions[1][i])) continue;
-        if (removeXwingByCols(board, num, positions[1][i], indexes, moves)) {
-            return true;
+
+    auto baseSets = getBaseSets(size);
+    for (auto k = 0; k < 2; k++) {
+        if (countBits(candidates[k]) < size) continue;
+        for (std::size_t n = 0; n < baseSets.second; n++) {
+            std::uint16_t base = baseSets.first[n];
+            if ((base & candidates[k]) != base) continue;
+            std::uint16_t cover = 0;
+            for (std::uint16_t rest = base; rest != 0; rest &= rest - 1) {
+                cover |= positions[k][firstBit(rest)];
+            }
+            if (countBits(cover) != size) continue;
+            if (k == 0 && removeFishByRows(board, num, base, cover, moves)) {
+                return true;
+            }
+            if (k == 1 && removeFishByCols(board, num, cover, base, moves)) {
+                return true;
+            }
         }
     }
     return false;
 }
 
+/**
+ * @brief Looks for xwings in the board
+ * 
+ * @param board to look through
+ * @param num to match with the x-wing
+ * @param moves vector that gets filled with the correct moves, if any
+ * @return true  if found any x-wings
+ * @return false otherwise
+ */
+bool findXwing(Board &board, const std::uint16_t num, MoveList &moves) {
+    return findFish(board, num, 2, moves);
+}
+
 /**
  * @brief Looks for unique rectangles
  * 
@@ -765,7 +1346,7 @@ bool findXwing(Board &board, const std::uint16_t num, std::vector<Move> &moves)
  * @return true if pencil marks can be removed
  * @return false otherwise
  */
-bool findUniqueRectangle(Board &board, const std::uint16_t num, std::vector<Move> &moves) {
+bool findUniqueRectangle(Board &board, const std::uint16_t num, MoveList &moves) {
     if (num == 0) return false;
     for (auto i = 0; i < 9; i++) {
         for (auto j = 0; j < 9; j++) {
@@ -778,8 +1359,8 @@ bool findUniqueRectangle(Board &board, const std::uint16_t num, std::vector<Move
             i_pos &= ~(1 << i); // remove the location that we are at
             j_pos &= ~(1 << j); // the one remaining is the intersection
             if ((i_pos == 0) || j_pos == 0) continue;
-            auto intersect_i = getSetBits(i_pos)[0];
-            auto intersect_j = getSetBits(j_pos)[0];
+            auto intersect_i = firstBit(i_pos);
+            auto intersect_j = firstBit(j_pos);
             // current location has box start idx i/3*3, j/3*3
             // one intersection has i/3*3, j_pos/3*3
             // other one has i_pos/3*3/ j/3*3
@@ -792,9 +1373,10 @@ bool findUniqueRectangle(Board &board, const std::uint16_t num, std::vector<Move
             boxj3 = (j / 3) * 3;
             if (!((boxi1 == boxi2 && boxj1 == boxj2) || (boxi1 == boxi3 && boxj1 == boxj3) || (boxi2 == boxj3 && boxj2 == boxj3))) continue;
             if (!board.isEmpty(intersect_i, intersect_j)) continue;
-            auto mark = board.getPencil(intersect_i, intersect_j) & num;
+            std::uint16_t mark = board.getPencil(intersect_i, intersect_j) & num;
             if (mark == 0) continue;
-            for (auto &unset : getSetBits(mark)) {
+            for (; mark != 0; mark &= mark - 1) {
+                char unset = firstBit(mark);
                 Move move = { (char)(unset + START_CHAR), intersect_i, intersect_j, &Board::pencil };
                 moves.push_back(move);
             }
@@ -804,103 +1386,6 @@ bool findUniqueRectangle(Board &board, const std::uint16_t num, std::vector<Move
     return false;
 }
 
-/**
- * @brief checks if two boxes are in the same unit
- * 
- * @param i_1 first box row
- * @param j_1 first box column
- * @param i_2 second box row
- * @param j_2 second box column
- * @return true if they are in the same unit
- * @return false if they aren't in the same unit
- */
-static bool canSee(char i_1, char j_1, char i_2, char j_2) {
-    if (i_1 == i_2) return true;
-    if (j_1 == j_2) return true;
-    char box_i_1, box_i_2, box_j_1, box_j_2;
-    box_i_1 = (i_1 / 3) * 3;
-    box_i_2 = (i_2 / 3) * 3;
-    box_j_1 = (j_1 / 3) * 3;
-    box_j_2 = (j_2 / 3) * 3;
-    return ((box_i_1 == box_i_2) && (box_j_1 == box_j_2));
-}
-
-/**
- * @brief seperates the all vector into two chains that see each other
- * 
- * @param chain_a starts with one item in it
- * @param chain_b empty vector
- * @param all all the found doubles
- * @return true if a link has been added to the chain
- * @return false all links have been searched through
- */
-static bool build_chain(std::vector<Coord> &chain_a, std::vector<Coord> &chain_b,  std::vector<Coord> &all) {
-    if (all.size() == 0) return false;
-    for (std::vector<Coord>::iterator link_itr = all.begin(); link_itr != all.end(); link_itr++) {
-        for (auto a : chain_a) {
-            if (canSee((*link_itr).i, (*link_itr).j, a.i, a.j)) {
-                chain_b.push_back(*link_itr);
-                link_itr = all.erase(link_itr);
-                return true;
-            }
-        }
-        for (auto b : chain_b) {
-            if (canSee((*link_itr).i, (*link_itr).j, b.i, b.j)) {
-                chain_a.push_back(*link_itr);
-                link_itr = all.erase(link_itr);
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
-/**
- * @brief looks for values that are seen by both chains and removes the pencil mark
- * 
- * @param board board that the chains have been found in
- * @param num pair that forms the chain
- * @param chain_a positions that see chain_b
- * @param chain_b positions that see chain_a
- * @param moves vector that found moves gets put into
- * @return true if moves are found
- * @return false if moves are not found
- */
-static bool removedByChain(Board &board, const std::uint16_t num, std::vector<Coord> chain_a, std::vector<Coord> chain_b, std::vector<Move> &moves) {
-    for (char i = 0; i < 9; i++) {
-        for (char j = 0; j < 9; j++) {
-            if (!board.isEmpty(i, j)) continue;
-            auto marks = board.getPencil(i, j) & num;
-            if (marks == 0) continue;
-            if (marks == num) continue;
-            bool seen_a = false;
-            bool seen_b = false;
-            for (auto &a : chain_a) {
-                if (canSee(i, j, a.i, a.j)) {
-                    seen_a = true;
-                    break;
-                }
-            }
-            for (auto &b : chain_b) {
-                if (canSee(i, j, b.i, b.j)) {
-                    seen_b = true;
-                    break;
-                }
-            }
-            if (seen_a && seen_b) {
-                bool should_ret = false;
-                for (auto unset : getSetBits(marks)) {
-                    Move move = {(char)(unset + START_CHAR), i, j, &Board::pencil};
-                    moves.push_back(move);
-                    should_ret = true;
-                }
-                if (should_ret) return true;
-            }
-        }
-    }
-    return false;
-}
-
 /**
  * @brief Looks for a chain of pairs
  * 
@@ -910,29 +1395,7 @@ static bool removedByChain(Board &board, const std::uint16_t num, std::vector<Co
  * @return true if moves are found
  * @return false if moves are not found
  */
-bool findChainOfPairs(Board &board, const std::uint16_t num, std::vector<Move> &moves) {
-    std::vector<Coord> all_doubles;
-    for (auto i = 0; i < 9; i++) {
-        for (auto j = 0; j < 9; j++) {
-            if (!board.isEmpty(i, j)) continue;
-            if (board.getPencil(i, j) != num) continue;
-            // Double in this location
-            Coord here = {(char)i, (char)j};
-            all_doubles.push_back(here);
-        }
-    }
-    if (all_doubles.size() < 3) return false;
-    int chain_idx = 0;
-    for (auto link : all_doubles) {
-        auto chain = all_doubles;
-        std::vector<Coord> chain_a, chain_b;
-        chain_a.push_back(link);
-        chain.erase(chain.begin() + chain_idx++);
-        while (build_chain(chain_a, chain_b, chain)) {};
-        if (chain_a.size() + chain_b.size() < 4) continue;
-        if (removedByChain(board, num, chain_a, chain_b, moves)) {
-            return true;
-        }
-    }
-    return false;
+bool findChainOfPairs(Board &board, const std::uint16_t num, MoveList &moves) {
+    ChainGraph graph(board);
+    return graph.findChain(board, num, moves);
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "Board.h"
 #include "config.h"
+#include "FixedVector.h"
+#include "Profile.h"
+#include <array>
 #include <string>
 
 struct Move {
@@ -14,21 +17,104 @@ struct Move {
     }
 };
 
+// Every finder returns as soon as it has moves, so a hint holds the moves
+// of one technique. Those either touch a square at most once (singles,
+// fish, chains, rectangles) or stay inside one unit, 9 squares with 9
+// marks each, so no hint has more than 81 moves. push_back asserts it.
+typedef FixedVector<Move, 81> MoveList;
+
+/**
+ * @brief Moves found by the human solver
+ * 
+ * The text of the hint is only made when asked for, graders never need it.
+ */
 struct Hint {
-    std::string hint1;
-    std::string hint2;
     int difficulty;
-    std::vector<Move> moves;
+    MoveList moves;
+    std::string hint1() const;
+    std::string hint2() const;
+};
+
+struct Grade {
+    int difficulty;
+    int moves;
+    bool solved;
+};
+
+// Difficulty of a board the solver can't give a hint for. Swordfish and
+// jellyfish came after it and got 16 and 17, so grades stored before them
+// keep their meaning.
+const int UNSOLVED_DIFFICULTY = 15;
+
+// Every unit as a set bit, bit n is unit n of the board position table
+const std::uint32_t ALL_UNITS = (1u << 27) - 1;
+// Every box as a set bit
+const std::uint16_t ALL_BOXES = (1u << 9) - 1;
+
+/**
+ * @brief Human solver that keeps what it found between hints
+ * 
+ * The position table of the board is compared with the one seen at the
+ * previous hint to find the units that changed. Singles are kept for every
+ * square and only updated where the units changed, and techniques that
+ * found nothing last time only search the units that changed since.
+ * The hints are the same as the ones solveHuman gives.
+ */
+class HumanSolver {
+    private:
+        enum tier {
+            POINTING,
+            DOUBLES,
+            LOCKED,
+            NAKED_TRIPLES,
+            NAKED_QUADS,
+            HIDDEN_TRIPLES,
+            HIDDEN_QUADS,
+            BUG,
+            CHAIN,
+            RECTANGLE,
+            XWING,
+            SWORDFISH,
+            JELLYFISH,
+            TIERS
+        };
+
+        Board &board;
+        std::array<std::array<std::uint16_t, 9>, 27> seen;
+        // [digit][row] columns of the squares that are naked or hidden singles
+        std::array<std::array<std::uint16_t, 9>, 9> nakedSingles;
+        std::array<std::array<std::uint16_t, 9>, 9> hiddenSingles;
+        // units that changed since each tier last found nothing
+        std::array<std::uint32_t, TIERS> stale;
+        Profile::Timer timer;
+
+        void update();
+        void updateNaked(int row, int col);
+        void updateHidden(int row, int col, int digit);
+        bool findSingle(Hint &hint);
+        bool findAllSingles(Hint &hint);
+        std::uint16_t staleBoxes(tier t) const;
+        std::uint64_t searchedCells(tier t) const;
+        bool found(tier t, bool hit);
+
+    public:
+        HumanSolver(Board &board);
+        Hint nextHint(bool allSingles = false);
+        Grade grade(bool allSingles = false);
 };
 
 Hint solveHuman(Board &board);
+Grade gradeHuman(Board &board, bool allSingles = false);
 bool findNakedSingles(Board &board, const std::uint16_t num, Move *move);
 bool findHiddenSingles(Board &board, const std::uint16_t num, Move *move);
-bool findPointingBox(Board &board, char i_start, char j_start, std::vector<Move> &moves);
-bool findLockedCandidates(Board &board, std::vector<Move> &moves);
-bool findHidden(Board &board, const std::uint16_t num, std::vector<Move> &moves);
-bool findNaked(Board &board, const std::uint16_t num, std::vector<Move> &moves);
+bool findPointingBox(Board &board, char i_start, char j_start, MoveList &moves);
+bool findLockedCandidates(Board &board, MoveList &moves, std::uint16_t boxes = ALL_BOXES);
+bool findHidden(Board &board, const std::uint16_t num, MoveList &moves, std::uint32_t units = ALL_UNITS);
+bool findNaked(Board &board, const std::uint16_t num, MoveList &moves, std::uint32_t units = ALL_UNITS);
+bool findHiddenSubset(Board &board, int size, MoveList &moves, std::uint32_t units = ALL_UNITS);
+bool findNakedSubset(Board &board, int size, MoveList &moves, std::uint32_t units = ALL_UNITS);
 bool findBug(Board &board, Move *move);
-bool findXwing(Board &board, const std::uint16_t num, std::vector<Move> &moves);
-bool findUniqueRectangle(Board &board, const std::uint16_t num, std::vector<Move> &moves);
-bool findChainOfPairs(Board &board, const std::uint16_t num, std::vector<Move> &move);
+bool findXwing(Board &board, const std::uint16_t num, MoveList &moves);
+bool findFish(Board &board, const std::uint16_t num, int size, MoveList &moves);
+bool findUniqueRectangle(Board &board, const std::uint16_t num, MoveList &moves);
+bool findChainOfPairs(Board &board, const std::uint16_t num, MoveList &move);
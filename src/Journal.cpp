@@ -0,0 +1,167 @@
+#include "Journal.h"
+
+Journal::Journal() : first(0), cursor(0), end(0), watched{} {
+}
+
+/**
+ * @brief Remembers a square as it is before the change being recorded
+ */
+void Journal::watch(Board &board, int cell) {
+    if (watched.has(cell)) {
+        return;
+    }
+    int row = Sudoku::ROW_OF[cell];
+    int col = Sudoku::COL_OF[cell];
+    watched.add(cell);
+    values[cell] = board.getPlayGrid()[row][col];
+    marks[cell] = board.getPencil(row, col);
+}
+
+/**
+ * @brief Remembers a square and its peers, the squares an insert can change
+ */
+void Journal::watchPeers(Board &board, int row, int col) {
+    int cell = row * Sudoku::SIZE + col;
+    watch(board, cell);
+    for (auto peer : Sudoku::PEERS[cell]) {
+        watch(board, peer);
+    }
+}
+
+/**
+ * @brief Adds the watched squares that changed as one step
+ *
+ * Anything that could be redone is thrown away, nothing is added when no
+ * square changed.
+ */
+void Journal::commit(Board &board) {
+    bool changed = false;
+    delta change;
+    while (watched.any()) {
+        int cell = watched.first();
+        watched.remove(cell);
+        int row = Sudoku::ROW_OF[cell];
+        int col = Sudoku::COL_OF[cell];
+        std::uint8_t value = board.getPlayGrid()[row][col];
+        std::uint16_t flipped = marks[cell] ^ board.getPencil(row, col);
+        if (value == values[cell] && flipped == 0) {
+            continue;
+        }
+        if (!changed) {
+            end = cursor;
+        }
+        else {
+            push(change);
+        }
+        changed = true;
+        change = {flipped, (std::uint8_t)cell, 0, values[cell], value};
+    }
+    if (changed) {
+        change.last = 1;
+        push(change);
+    }
+}
+
+/**
+ * @brief Adds a delta at the end, dropping the oldest step when full
+ */
+void Journal::push(const delta &change) {
+    if (end - first == CAPACITY) {
+        while (!ring[first++ % CAPACITY].last) {
+        }
+    }
+    ring[end++ % CAPACITY] = change;
+    cursor = end;
+}
+
+void Journal::apply(Board &board, const delta &change, bool forward) {
+    int row = Sudoku::ROW_OF[change.cell];
+    int col = Sudoku::COL_OF[change.cell];
+    board.setSquare(row, col, forward ? change.after : change.before, board.getPencil(row, col) ^ change.marks);
+}
+
+/**
+ * @brief Inserts into the board and records it
+ *
+ * @return what Board::insert returns
+ */
+bool Journal::insert(Board &board, char val, int row, int col) {
+    watchPeers(board, row, col);
+    bool ret = board.insert(val, row, col);
+    commit(board);
+    return ret;
+}
+
+/**
+ * @brief Pencils into the board and records it
+ *
+ * @return what Board::pencil returns
+ */
+bool Journal::pencil(Board &board, char val, int row, int col) {
+    watch(board, row * Sudoku::SIZE + col);
+    bool ret = board.pencil(val, row, col);
+    commit(board);
+    return ret;
+}
+
+void Journal::autoPencil(Board &board) {
+    for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+        watch(board, cell);
+    }
+    board.autoPencil();
+    commit(board);
+}
+
+/**
+ * @brief Makes all the moves of a hint as one step
+ */
+void Journal::apply(Board &board, Hint &hint) {
+    for (auto &move : hint.moves) {
+        watchPeers(board, move.row, move.col);
+        move(&board);
+    }
+    commit(board);
+}
+
+/**
+ * @brief Takes back the last step
+ *
+ * @return false if there is nothing to undo
+ */
+bool Journal::undo(Board &board) {
+    if (!canUndo()) {
+        return false;
+    }
+    do {
+        cursor--;
+        apply(board, ring[cursor % CAPACITY], false);
+    } while (cursor > first && !ring[(cursor - 1) % CAPACITY].last);
+    return true;
+}
+
+/**
+ * @brief Makes the last step that was taken back again
+ *
+ * @return false if there is nothing to redo
+ */
+bool Journal::redo(Board &board) {
+    if (!canRedo()) {
+        return false;
+    }
+    do {
+        apply(board, ring[cursor % CAPACITY], true);
+    } while (!ring[cursor++ % CAPACITY].last);
+    return true;
+}
+
+bool Journal::canUndo() const {
+    return cursor > first;
+}
+
+bool Journal::canRedo() const {
+    return cursor < end;
+}
+
+void Journal::clear() {
+    first = cursor = end = 0;
+}
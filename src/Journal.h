@@ -0,0 +1,60 @@
+#pragma once
+#include "Board.h"
+#include "HumanSolve.h"
+#include "Sudoku/Units.h"
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Journal of the changes made to a board for undo and redo
+ *
+ * Every change is kept as the squares it touched: the digit before and
+ * after and the pencil marks that flipped. A step is everything changed by
+ * one action of the player, undo and redo only touch the squares of the
+ * step. The deltas are kept in a ring, when it's full the oldest steps are
+ * dropped.
+ */
+class Journal {
+    public:
+        static const std::size_t CAPACITY = 4096;
+
+        struct delta {
+            std::uint16_t marks; // pencil marks that flipped
+            std::uint8_t cell : 7;
+            std::uint8_t last : 1; // last delta of a step
+            std::uint8_t before : 4;
+            std::uint8_t after : 4;
+        };
+
+    private:
+        std::array<delta, CAPACITY> ring;
+        // deltas first up to cursor can be undone, cursor up to end redone
+        std::uint64_t first;
+        std::uint64_t cursor;
+        std::uint64_t end;
+
+        // squares watched by the change being recorded as they were before
+        Sudoku::cellSet watched;
+        std::array<std::uint8_t, Sudoku::CELLS> values;
+        std::array<std::uint16_t, Sudoku::CELLS> marks;
+
+        void watch(Board &board, int cell);
+        void watchPeers(Board &board, int row, int col);
+        void commit(Board &board);
+        void push(const delta &change);
+        void apply(Board &board, const delta &change, bool forward);
+
+    public:
+        Journal();
+
+        bool insert(Board &board, char val, int row, int col);
+        bool pencil(Board &board, char val, int row, int col);
+        void autoPencil(Board &board);
+        void apply(Board &board, Hint &hint);
+
+        bool undo(Board &board);
+        bool redo(Board &board);
+        bool canUndo() const;
+        bool canRedo() const;
+        void clear();
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Cache of the last used values, keyed by a board hash
+ *
+ * Meant for a few dozen entries: the keys are kept together and looked up
+ * one after the other, which for so few is faster than hashing them again.
+ * Never allocates, when full the value used longest ago is replaced.
+ */
+template <typename T, std::size_t N>
+class LruCache {
+    private:
+        std::array<std::uint64_t, N> keys;
+        std::array<std::uint64_t, N> used; // 0 for an empty slot
+        std::array<T, N> values;
+        std::uint64_t clock = 0;
+
+        std::size_t find(std::uint64_t key) const {
+            for (std::size_t i = 0; i < N; i++) {
+                if (used[i] != 0 && keys[i] == key) {
+                    return i;
+                }
+            }
+            return N;
+        }
+
+    public:
+        LruCache() {
+            used.fill(0);
+        }
+
+        /**
+         * @brief Gets the value of a key
+         *
+         * @param key to look up
+         * @param value set to the value if the key is cached
+         * @return true if the key is cached
+         */
+        bool get(std::uint64_t key, T &value) {
+            std::size_t i = find(key);
+            if (i == N) {
+                return false;
+            }
+            used[i] = ++clock;
+            value = values[i];
+            return true;
+        }
+
+        /**
+         * @brief Caches the value of a key, replacing the oldest when full
+         */
+        void put(std::uint64_t key, const T &value) {
+            std::size_t i = find(key);
+            if (i == N) {
+                i = 0;
+                for (std::size_t j = 1; j < N && used[i] != 0; j++) {
+                    if (used[j] < used[i]) {
+                        i = j;
+                    }
+                }
+                keys[i] = key;
+            }
+            used[i] = ++clock;
+            values[i] = value;
+        }
+
+        void clear() {
+            used.fill(0);
+        }
+
+        std::size_t size() const {
+            std::size_t count = 0;
+            for (auto u : used) {
+                count += u != 0;
+            }
+            return count;
+        }
+};
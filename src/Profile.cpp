@@ -0,0 +1,160 @@
+#include "Profile.h"
+#include <iomanip>
+#include <mutex>
+
+static const char *const NAMES[] = {
+    "singles",
+    "pointing",
+    "doubles",
+    "locked",
+    "naked triples",
+    "naked quads",
+    "hidden triples",
+    "hidden quads",
+    "bug",
+    "chain",
+    "rectangle",
+    "x-wing",
+    "swordfish",
+    "jellyfish",
+};
+
+static_assert(sizeof(NAMES) / sizeof(NAMES[0]) == Profile::TECHNIQUES, "every technique needs a name");
+
+#ifdef TUIDOKU_PROFILE
+static void add(Profile::table &to, const Profile::table &from) {
+    for (auto t = 0; t < Profile::TECHNIQUES; t++) {
+        to[t].invocations += from[t].invocations;
+        to[t].hits += from[t].hits;
+        to[t].totalNs += from[t].totalNs;
+        to[t].cells += from[t].cells;
+        if (from[t].maxNs > to[t].maxNs) {
+            to[t].maxNs = from[t].maxNs;
+        }
+    }
+}
+
+/**
+ * @brief Table of one thread
+ *
+ * The tables of the running threads are kept in a linked list so that
+ * registering a thread never allocates. A thread that exits adds its
+ * counts to the retired table.
+ */
+struct threadTable {
+    Profile::table counts;
+    threadTable *next;
+
+    threadTable();
+    ~threadTable();
+};
+
+static std::mutex lock;
+static threadTable *threads = nullptr;
+static Profile::table retired = {};
+
+threadTable::threadTable() : counts{}, next(nullptr) {
+    std::lock_guard<std::mutex> guard(lock);
+    next = threads;
+    threads = this;
+}
+
+threadTable::~threadTable() {
+    std::lock_guard<std::mutex> guard(lock);
+    add(retired, counts);
+    for (threadTable **curr = &threads; *curr != nullptr; curr = &(*curr)->next) {
+        if (*curr == this) {
+            *curr = next;
+            break;
+        }
+    }
+}
+
+static thread_local threadTable local;
+
+/**
+ * @brief Records one try of a technique in the table of this thread
+ *
+ * @param t technique that was tried
+ * @param hit if it found anything
+ * @param ns time it took
+ * @param cells number of squares in the units it searched
+ */
+void Profile::record(technique t, bool hit, std::uint64_t ns, std::uint64_t cells) {
+    counters &count = local.counts[t];
+    count.invocations++;
+    count.hits += hit;
+    count.totalNs += ns;
+    count.cells += cells;
+    if (ns > count.maxNs) {
+        count.maxNs = ns;
+    }
+}
+#endif
+
+/**
+ * @brief Adds together the tables of every thread
+ *
+ * Should not be called while other threads are solving, their counts
+ * can be part way through an update.
+ *
+ * @return Profile::table counts of every thread that has recorded anything
+ */
+Profile::table Profile::collect() {
+    table total = {};
+#ifdef TUIDOKU_PROFILE
+    std::lock_guard<std::mutex> guard(lock);
+    add(total, retired);
+    for (threadTable *curr = threads; curr != nullptr; curr = curr->next) {
+        add(total, curr->counts);
+    }
+#endif
+    return total;
+}
+
+/**
+ * @brief Clears the tables of every thread
+ */
+void Profile::reset() {
+#ifdef TUIDOKU_PROFILE
+    std::lock_guard<std::mutex> guard(lock);
+    retired = {};
+    for (threadTable *curr = threads; curr != nullptr; curr = curr->next) {
+        curr->counts = {};
+    }
+#endif
+}
+
+const char *Profile::name(technique t) {
+    return NAMES[t];
+}
+
+/**
+ * @brief Prints the counts as a tab separated table, times in microseconds
+ */
+void Profile::printTable(const table &counts, std::ostream &stream) {
+    stream << "technique\tcalls\thits\ttotal (us)\tmean (us)\tmax (us)\tcells\n";
+    stream << std::fixed << std::setprecision(3);
+    for (auto t = 0; t < TECHNIQUES; t++) {
+        const counters &count = counts[t];
+        double mean = count.invocations == 0 ? 0 : (double)count.totalNs / count.invocations;
+        stream << NAMES[t] << '\t' << count.invocations << '\t' << count.hits << '\t'
+               << count.totalNs / 1000.0 << '\t' << mean / 1000.0 << '\t'
+               << count.maxNs / 1000.0 << '\t' << count.cells << '\n';
+    }
+}
+
+/**
+ * @brief Prints the counts as a JSON array with one object per technique
+ */
+void Profile::printJson(const table &counts, std::ostream &stream) {
+    stream << "[\n";
+    for (auto t = 0; t < TECHNIQUES; t++) {
+        const counters &count = counts[t];
+        stream << "  {\"technique\": \"" << NAMES[t] << "\", \"invocations\": " << count.invocations
+               << ", \"hits\": " << count.hits << ", \"total_ns\": " << count.totalNs
+               << ", \"max_ns\": " << count.maxNs << ", \"cells\": " << count.cells << '}'
+               << (t + 1 < TECHNIQUES ? ",\n" : "\n");
+    }
+    stream << "]\n";
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Counters for every technique the human solver tries
+ *
+ * Every thread records into its own table, collect adds them together.
+ * Recording is only compiled in when TUIDOKU_PROFILE is defined, the
+ * TUIDOKU_PROFILE cmake option does that. Otherwise record and the timer
+ * do nothing and collect returns an empty table.
+ */
+namespace Profile {
+#ifdef TUIDOKU_PROFILE
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    // In the order the solver tries them
+    enum technique {
+        SINGLES,
+        POINTING,
+        DOUBLES,
+        LOCKED,
+        NAKED_TRIPLES,
+        NAKED_QUADS,
+        HIDDEN_TRIPLES,
+        HIDDEN_QUADS,
+        BUG,
+        CHAIN,
+        RECTANGLE,
+        XWING,
+        SWORDFISH,
+        JELLYFISH,
+        TECHNIQUES
+    };
+
+    struct counters {
+        std::uint64_t invocations;
+        std::uint64_t hits;
+        std::uint64_t totalNs;
+        std::uint64_t maxNs;
+        std::uint64_t cells;
+    };
+
+    typedef std::array<counters, TECHNIQUES> table;
+
+    /**
+     * @brief Measures the time between laps
+     */
+    class Timer {
+        private:
+#ifdef TUIDOKU_PROFILE
+            std::chrono::steady_clock::time_point last;
+#endif
+
+        public:
+            void start() {
+#ifdef TUIDOKU_PROFILE
+                last = std::chrono::steady_clock::now();
+#endif
+            }
+
+            /**
+             * @brief Gets the nanoseconds since start or the last lap
+             */
+            std::uint64_t lap() {
+#ifdef TUIDOKU_PROFILE
+                auto now = std::chrono::steady_clock::now();
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last);
+                last = now;
+                return elapsed.count();
+#else
+                return 0;
+#endif
+            }
+    };
+
+#ifdef TUIDOKU_PROFILE
+    void record(technique t, bool hit, std::uint64_t ns, std::uint64_t cells);
+#else
+    inline void record(technique, bool, std::uint64_t, std::uint64_t) {}
+#endif
+
+    table collect();
+    void reset();
+    const char *name(technique t);
+    void printTable(const table &counts, std::ostream &stream);
+    void printJson(const table &counts, std::ostream &stream);
+}
@@ -1,69 +1,198 @@
 #include "Sudoku.h"
+#include "../ThreadPool.h"
+#include "../config.h"
 #include <algorithm>
 #include <chrono>
 #include <random>
+#include <vector>
+
+// Puzzles with more empty cells than this are searched for with generateSparse
+const int SPARSE_UNKNOWNS = 58;
+
+struct Cell
+{
+    int row;
+    int col;
+};
+
+/**
+ * @brief Checks if the grid still has a single solution without the given clues
+ *
+ * @param grid puzzle to check, is not modified
+ * @param removed cells to empty before solving
+ * @return true if the puzzle without the cells has exactly one solution
+ */
+static bool isUniqueWithout(const Sudoku::puzzle &grid, const std::vector<Cell> &removed) {
+    Sudoku::puzzle copy = grid;
+    for (const auto &cell : removed) {
+        copy[cell.row][cell.col] = 0;
+    }
+    return Sudoku::solve(copy, false);
+}
+
+/**
+ * @brief Removes clues from grid while keeping a unique solution
+ *
+ * Candidates are tested in batches, one per thread in the pool, against the
+ * current grid. A clue that cannot be removed stays necessary for every
+ * puzzle with fewer clues, so it is never tested again. The removable clues
+ * of a batch are then committed together if the grid stays unique without
+ * all of them, otherwise only the first is committed and the rest are
+ * tested again in the next batch.
+ *
+ * @param grid puzzle to remove clues from
+ * @param candidates cells to try, in the order they should be removed
+ * @param unknown stop after this many cells are empty, 0 to remove as many as possible
+ * @param pool threads to test the candidates on
+ * @return number of clues removed
+ */
+static int removeClues(Sudoku::puzzle &grid, std::vector<Cell> candidates, int unknown, ThreadPool &pool) {
+    int removed = 0;
+    const std::size_t batchSize = pool.size();
+    std::vector<char> removable;
+    std::vector<Cell> batch;
+    std::vector<Cell> keep;
+    while (!candidates.empty()) {
+        std::size_t size = std::min(batchSize, candidates.size());
+        if (unknown != 0) {
+            size = std::min(size, (std::size_t)(unknown - removed));
+        }
+        batch.assign(candidates.begin(), candidates.begin() + size);
+        candidates.erase(candidates.begin(), candidates.begin() + size);
+
+        removable.assign(size, false);
+        pool.run(size, [&](std::size_t i) {
+            removable[i] = isUniqueWithout(grid, {batch[i]});
+        });
+
+        keep.clear();
+        for (std::size_t i = 0; i < size; i++) {
+            if (removable[i]) {
+                keep.push_back(batch[i]);
+            }
+        }
+        if (keep.empty()) {
+            continue;
+        }
+        if (keep.size() > 1 && !isUniqueWithout(grid, keep)) {
+            // Removals conflict with each other, commit the first and retest the rest
+            candidates.insert(candidates.begin(), keep.begin() + 1, keep.end());
+            keep.resize(1);
+        }
+        for (const auto &cell : keep) {
+            grid[cell.row][cell.col] = 0;
+            removed++;
+        }
+        if (unknown != 0 && removed >= unknown) {
+            break;
+        }
+    }
+    return removed;
+}
+
+/**
+ * @brief Creates a solved grid and every cell of it in random order
+ *
+ * @param grid filled with a random solution
+ * @return std::vector<Cell> shuffled positions of the grid
+ */
+static std::vector<Cell> randomSolution(Sudoku::puzzle &grid) {
+    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
+    grid = {};
+    Sudoku::solve(grid, true);
+    std::vector<Cell> cells;
+    for (auto i = 0; i < Sudoku::SIZE; i++) {
+        for (auto j = 0; j < Sudoku::SIZE; j++) {
+            cells.push_back({i, j});
+        }
+    }
+    shuffle(cells.begin(), cells.end(), std::default_random_engine(seed));
+    return cells;
+}
 
 Sudoku::puzzle Sudoku::generate() {
     return generate(0);
 }
+
 Sudoku::puzzle Sudoku::generate(int unknown) {
+    return generate(unknown, ThreadPool::defaultThreads());
+}
+
+Sudoku::puzzle Sudoku::generate(int unknown, puzzle &solution) {
+    return generate(unknown, ThreadPool::defaultThreads(), solution);
+}
+
+Sudoku::puzzle Sudoku::generate(int unknown, unsigned threads) {
+    puzzle solution;
+    return generate(unknown, threads, solution);
+}
+
+/**
+ * @brief Generates a puzzle with a unique solution
+ *
+ * Random removal almost never reaches more than SPARSE_UNKNOWNS empty
+ * cells, so those puzzles are searched for with generateSparse instead.
+ * If that search times out the puzzle with the most empty cells found is
+ * returned, use countEmpty to tell if the request was met.
+ *
+ * @param unknown number of empty cells, 0 to remove as many as possible
+ * @param threads number of threads used to test removals
+ * @param solution set to the solution of the puzzle
+ * @return puzzle with the requested number of empty cells, or fewer if
+ *         the search timed out
+ */
+Sudoku::puzzle Sudoku::generate(int unknown, unsigned threads, puzzle &solution) {
     if (unknown > 64) {
         unknown = 64;
     }
     if (unknown < 0) {
         unknown = 0;
     }
-    puzzle grid = {};
-
-    struct Cell
-    {
-        int row;
-        int col;
-    };
-
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    /*
-    std::array<int, 9> firstRow;
-    for (auto i = 1; i <= 9; i++) {
-        firstRow[i - 1] = i;
+    puzzle grid;
+    if (unknown > SPARSE_UNKNOWNS) {
+        searchStats stats;
+        generateSparse(SIZE * SIZE - unknown, grid, threads, GENERATE_TIMEOUT, stats);
+        solution = grid;
+        solve(solution);
+        return grid;
     }
-    shuffle(firstRow.begin(), firstRow.end(), std::default_random_engine(seed));
-    grid[0] = firstRow;
-    */
-    solve(grid, true);
-    std::array<Cell, SIZE*SIZE> cells;
-    int count = 0;
-    for (auto i = 0; i < SIZE; i++) {
-        for (auto j = 0; j < SIZE; j++) {
-            cells[count].row = i;
-            cells[count].col = j;
-            count++;
+    ThreadPool pool(threads);
+    while (true) {
+        auto cells = randomSolution(grid);
+        solution = grid;
+        int removed = removeClues(grid, cells, unknown, pool);
+        if (unknown == 0 || removed >= unknown) {
+            return grid;
         }
+        // Could't find a puzzle with the given unknowns, trying again
     }
+}
 
-    // Shuffle to randomly remove positions
-    shuffle(cells.begin(), cells.end(), std::default_random_engine(seed));
+Sudoku::puzzle Sudoku::generateMinimal() {
+    return generateMinimal(ThreadPool::defaultThreads());
+}
 
-    int i = 0;
-    puzzle copy;
-    for (const auto &cell : cells) {
-        int removed = grid[cell.row][cell.col];
-        grid[cell.row][cell.col] = 0;
-        copy = grid;
-        bool isUnique = solve(copy, false);
-        if (!isUnique) {
-            // Removal made it a bad move, put it back
-            grid[cell.row][cell.col] = removed;
-        }
-        else {
-            i++;
-        }
-        if (unknown != 0 && i >= unknown) {
-            break;
-        }
-    }
-    if (unknown != 0 && i < unknown) { // Could't find a puzzle with the given unknowns
-        return generate(unknown); // trying again
-    }
+Sudoku::puzzle Sudoku::generateMinimal(puzzle &solution) {
+    return generateMinimal(ThreadPool::defaultThreads(), solution);
+}
+
+Sudoku::puzzle Sudoku::generateMinimal(unsigned threads) {
+    puzzle solution;
+    return generateMinimal(threads, solution);
+}
+
+/**
+ * @brief Generates a puzzle where every clue is necessary for a unique solution
+ *
+ * @param threads number of threads used to test clues
+ * @param solution set to the solution of the puzzle
+ * @return puzzle that becomes ambiguous if any clue is removed
+ */
+Sudoku::puzzle Sudoku::generateMinimal(unsigned threads, puzzle &solution) {
+    ThreadPool pool(threads);
+    puzzle grid;
+    auto cells = randomSolution(grid);
+    solution = grid;
+    removeClues(grid, cells, 0, pool);
     return grid;
-}
\ No newline at end of file
+}
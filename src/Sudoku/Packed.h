@@ -0,0 +1,70 @@
+#pragma once
+#include "Sudoku.h"
+#include "Units.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace Sudoku {
+    /**
+     * @brief Puzzle packed two squares to a byte
+     *
+     * Square n is in byte n / 2, the low four bits for even squares and the
+     * high four for odd ones. It takes 41 bytes where a puzzle takes 324,
+     * for keeping many puzzles in memory, on disk or in a cache. Unpack it
+     * where the squares are used one by one.
+     */
+    struct packed {
+        static const std::size_t BYTES = (CELLS + 1) / 2;
+        std::array<std::uint8_t, BYTES> bytes;
+
+        int get(int cell) const {
+            return (bytes[cell / 2] >> (cell % 2 * 4)) & 0xF;
+        }
+        int get(int row, int col) const {
+            return get(row * SIZE + col);
+        }
+        void set(int cell, int val) {
+            int shift = cell % 2 * 4;
+            bytes[cell / 2] = (bytes[cell / 2] & ~(0xF << shift)) | (val << shift);
+        }
+        void set(int row, int col, int val) {
+            set(row * SIZE + col, val);
+        }
+        bool operator==(const packed &r) const {
+            return bytes == r.bytes;
+        }
+        bool operator!=(const packed &r) const {
+            return bytes != r.bytes;
+        }
+    };
+    static_assert(sizeof(packed) == packed::BYTES, "a packed puzzle is only its bytes");
+
+    inline packed pack(const puzzle &grid) {
+        packed out = {};
+        for (auto cell = 0; cell < CELLS; cell += 2) {
+            int high = cell + 1 < CELLS ? grid[ROW_OF[cell + 1]][COL_OF[cell + 1]] : 0;
+            out.bytes[cell / 2] = grid[ROW_OF[cell]][COL_OF[cell]] | (high << 4);
+        }
+        return out;
+    }
+
+    /**
+     * @brief Packs a puzzle written as 81 characters from '0' to '9'
+     */
+    inline packed pack(const std::string &squares) {
+        packed out = {};
+        for (auto cell = 0; cell < CELLS; cell++) {
+            out.set(cell, squares[cell] - '0');
+        }
+        return out;
+    }
+
+    inline puzzle unpack(const packed &grid) {
+        puzzle out;
+        for (auto cell = 0; cell < CELLS; cell++) {
+            out[ROW_OF[cell]][COL_OF[cell]] = grid.get(cell);
+        }
+        return out;
+    }
+}
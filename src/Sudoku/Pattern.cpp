@@ -0,0 +1,172 @@
+#include "Sudoku.h"
+#include "../ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+// Number of shuffled variants of a solved grid that are tried before solving a new one
+const int VARIANTS_PER_GRID = 256;
+
+/**
+ * @brief Creates a random grid that is equivalent to base
+ *
+ * Rows are shuffled within their band, bands are shuffled, the same is
+ * done for columns and stacks, and the grid is transposed half the time.
+ * All of these keep the grid a valid solution.
+ *
+ * @param base solved grid to shuffle
+ * @param gen random number generator
+ * @return Sudoku::puzzle shuffled copy of base
+ */
+static Sudoku::puzzle shuffleGrid(const Sudoku::puzzle &base, std::mt19937 &gen) {
+    std::array<int, 3> bands = {0, 1, 2};
+    std::array<int, 3> stacks = {0, 1, 2};
+    std::array<int, Sudoku::SIZE> rows;
+    std::array<int, Sudoku::SIZE> cols;
+    std::shuffle(bands.begin(), bands.end(), gen);
+    std::shuffle(stacks.begin(), stacks.end(), gen);
+    for (auto i = 0; i < 3; i++) {
+        std::array<int, 3> inRow = {0, 1, 2};
+        std::array<int, 3> inCol = {0, 1, 2};
+        std::shuffle(inRow.begin(), inRow.end(), gen);
+        std::shuffle(inCol.begin(), inCol.end(), gen);
+        for (auto j = 0; j < 3; j++) {
+            rows[i * 3 + j] = bands[i] * 3 + inRow[j];
+            cols[i * 3 + j] = stacks[i] * 3 + inCol[j];
+        }
+    }
+    bool transpose = gen() & 1;
+
+    Sudoku::puzzle grid;
+    for (auto i = 0; i < Sudoku::SIZE; i++) {
+        for (auto j = 0; j < Sudoku::SIZE; j++) {
+            grid[i][j] = transpose ? base[cols[j]][rows[i]] : base[rows[i]][cols[j]];
+        }
+    }
+    return grid;
+}
+
+/**
+ * @brief Checks if four cells form a swappable rectangle without any clues
+ *
+ * Four cells holding a b / b a that lie in two boxes can have their digits
+ * swapped, so at least one of them has to be a clue.
+ */
+static bool isOpenRectangle(const Sudoku::puzzle &grid, const Sudoku::mask &clues, int r1, int r2, int c1, int c2) {
+    if (grid[r1][c1] != grid[r2][c2] || grid[r1][c2] != grid[r2][c1]) return false;
+    return !clues[r1][c1] && !clues[r1][c2] && !clues[r2][c1] && !clues[r2][c2];
+}
+
+/**
+ * @brief Cheap checks that rule out grids whose clues cannot have a unique solution
+ *
+ * @param grid solved grid
+ * @param clues positions that will be given
+ * @return true if the grid should be checked with the solver
+ * @return false if the clues are known to have several solutions
+ */
+static bool canBeUnique(const Sudoku::puzzle &grid, const Sudoku::mask &clues) {
+    // At least 8 different digits have to be given
+    std::uint16_t digits = 0;
+    for (auto i = 0; i < Sudoku::SIZE; i++) {
+        for (auto j = 0; j < Sudoku::SIZE; j++) {
+            if (clues[i][j]) digits |= (1 << grid[i][j]);
+        }
+    }
+    int count = 0;
+    for (auto d = 1; d <= Sudoku::SIZE; d++) {
+        if ((digits & (1 << d)) != 0) count++;
+    }
+    if (count < Sudoku::SIZE - 1) return false;
+
+    // Rectangles where two of the rows or two of the columns share boxes
+    for (auto r1 = 0; r1 < Sudoku::SIZE; r1++) {
+        for (auto r2 = r1 + 1; r2 < Sudoku::SIZE; r2++) {
+            bool sameBand = (r1 / 3) == (r2 / 3);
+            for (auto c1 = 0; c1 < Sudoku::SIZE; c1++) {
+                for (auto c2 = c1 + 1; c2 < Sudoku::SIZE; c2++) {
+                    if (!sameBand && (c1 / 3) != (c2 / 3)) continue;
+                    if (isOpenRectangle(grid, clues, r1, r2, c1, c2)) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Counts the number of clues in a mask
+ */
+int Sudoku::countClues(const mask &clues) {
+    int count = 0;
+    for (auto &row : clues) {
+        for (auto clue : row) {
+            if (clue) count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Searches for a puzzle with clues in exactly the positions of a mask
+ *
+ * Every thread solves a random grid and tries many shuffled variants of it,
+ * keeping only the digits on the mask. Variants that are known to have
+ * several solutions are rejected before the solver is used.
+ *
+ * @param clues positions that should be given
+ * @param grid set to the puzzle that was found
+ * @param threads number of threads searching at the same time
+ * @param timeout give up after this many seconds, 0 to search until found
+ * @param stats number of attempts and seconds spent searching
+ * @return true if a puzzle with a unique solution was found
+ */
+bool Sudoku::generateFromMask(const mask &clues, puzzle &grid, unsigned threads, int timeout, searchStats &stats) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(timeout);
+    std::atomic<bool> found(false);
+    std::atomic<long> attempts(0);
+    std::mutex resultLock;
+
+    // A unique puzzle needs at least 17 clues
+    bool possible = countClues(clues) >= 17;
+
+    ThreadPool pool(threads);
+    pool.run(possible ? pool.size() : 0, [&](std::size_t thread) {
+        std::random_device rd;
+        std::mt19937 gen(rd() + thread);
+        while (!found) {
+            puzzle base = {};
+            solve(base, true);
+            for (auto variant = 0; variant < VARIANTS_PER_GRID && !found; variant++) {
+                if (timeout > 0 && std::chrono::steady_clock::now() > deadline) {
+                    return;
+                }
+                attempts++;
+                puzzle candidate = shuffleGrid(base, gen);
+                if (!canBeUnique(candidate, clues)) continue;
+                for (auto i = 0; i < SIZE; i++) {
+                    for (auto j = 0; j < SIZE; j++) {
+                        if (!clues[i][j]) candidate[i][j] = 0;
+                    }
+                }
+                puzzle copy = candidate;
+                if (!solve(copy, false)) continue;
+
+                std::lock_guard<std::mutex> guard(resultLock);
+                if (!found) {
+                    grid = candidate;
+                    found = true;
+                }
+            }
+        }
+    });
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    stats.attempts = attempts;
+    stats.seconds = elapsed.count();
+    return found;
+}
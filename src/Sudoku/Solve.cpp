@@ -65,7 +65,7 @@ static DancingLink *smallestColumn(DancingLink *root);
  * @return true if solutions found are greater than one
  * @return false no solutions found
  */
-bool backTrack(int depth, int &solutions, DancingLink *root, Sudoku::puzzle &grid, DancingLink **solutionSet);
+bool backTrack(int depth, int &solutions, DancingLink *root, Sudoku::puzzle **grids, DancingLink **solutionSet);
 
 /**
  * @brief Create a Puzzle from a solutionset
@@ -78,12 +78,16 @@ static void createPuzzle(int depth, Sudoku::puzzle &grid, DancingLink **solution
  * @brief Solves a sudoku puzzle
  * 
  * @param grid puzzle to be solved
+ * @param randomize shuffle the rows of the constraint grid to get a random solution
+ * @param second puzzle to put a second solution into, may be the same as grid
  * @return true if there is one solution
  * @return false if there are multiple solutions or if no solutions were found
  */
-bool Sudoku::solve(puzzle &grid, bool randomize) {
+static bool solveGrid(Sudoku::puzzle &grid, bool randomize, Sudoku::puzzle &second) {
+    using namespace Sudoku;
     // Set up buffers that will hold the grid
-    DancingLink* root = new DancingLink;
+    DancingLink header;
+    DancingLink *root = &header;
     root->colHeader = root;
     root->up = root;
     root->down = root;
@@ -184,28 +188,54 @@ bool Sudoku::solve(puzzle &grid, bool randomize) {
 
     // Solving the board
     int solutions = 0;
-    bool foundSolution = backTrack(0, solutions, root, grid, solutionSet);
-    delete root;
+    puzzle *grids[2] = {&grid, &second};
+    bool foundSolution = backTrack(0, solutions, root, grids, solutionSet);
     return solutions == 1;
 }
 
+/**
+ * @brief Solves a sudoku puzzle
+ * 
+ * @param grid puzzle to be solved
+ * @param randomize shuffle the rows of the constraint grid to get a random solution
+ * @return true if there is one solution
+ * @return false if there are multiple solutions or if no solutions were found
+ */
+bool Sudoku::solve(puzzle &grid, bool randomize) {
+    return solveGrid(grid, randomize, grid);
+}
+
 bool Sudoku::solve(puzzle &grid) {
     return solve(grid, false);
 }
 
+/**
+ * @brief Solves a sudoku puzzle and keeps a second solution if there is one
+ * 
+ * @param grid puzzle to be solved, filled with the first solution found
+ * @param second filled with the second solution found, left as the puzzle if there is none
+ * @return true if there is one solution
+ * @return false if there are multiple solutions or if no solutions were found
+ */
+bool Sudoku::solve(puzzle &grid, puzzle &second) {
+    second = grid;
+    return solveGrid(grid, false, second);
+}
+
 /**
  * @brief Actual DLX algorithm
  * 
  * @param depth current depth, used for creating the board
  * @param solutions number of solutions found
  * @param root root of the constraint grid
+ * @param grids where the first and second solution are put
  * @return true if a solution is found
  * @return false if no solution is found
  */
-bool backTrack(int depth, int &solutions, DancingLink *root, Sudoku::puzzle &grid, DancingLink **solutionSet) {
+bool backTrack(int depth, int &solutions, DancingLink *root, Sudoku::puzzle **grids, DancingLink **solutionSet) {
     if (root->right == root) {
+        createPuzzle(depth, *grids[solutions], solutionSet);
         solutions++;
-        createPuzzle(depth, grid, solutionSet);
         return true;
     }
 
@@ -218,7 +248,7 @@ bool backTrack(int depth, int &solutions, DancingLink *root, Sudoku::puzzle &gri
         for (cur_col = row->right; cur_col != row; cur_col = cur_col->right) {
             cur_col->colHeader->cover();
         }
-        if (backTrack(depth + 1, solutions, root, grid, solutionSet) && solutions > 1) {
+        if (backTrack(depth + 1, solutions, root, grids, solutionSet) && solutions > 1) {
             return true;
         }
         for (cur_col = row->left; cur_col != row; cur_col = cur_col->left) {
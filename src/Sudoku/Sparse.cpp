@@ -0,0 +1,212 @@
+#include "Sudoku.h"
+#include "../ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <vector>
+
+typedef std::bitset<Sudoku::SIZE * Sudoku::SIZE> clueSet;
+
+// Swaps tried without removing a clue before starting over with a new grid
+const int STAGNATION_LIMIT = 200;
+// Unavoidable sets remembered per grid
+const std::size_t MAX_UNAVOIDABLE = 4096;
+
+/**
+ * @brief Search state for one solution grid
+ *
+ * Every time a set of clues turns out to have several solutions the cells
+ * where the two solutions differ are remembered. At least one of those
+ * cells has to be a clue, so later candidates that miss any remembered set
+ * are rejected without using the solver.
+ */
+struct Climber {
+    Sudoku::puzzle solution;
+    std::vector<clueSet> unavoidable;
+    std::mt19937 gen;
+
+    /**
+     * @brief Finds a remembered unavoidable set that none of the clues are in
+     *
+     * @return const clueSet* the set, nullptr if every set is hit
+     */
+    const clueSet *missedSet(const clueSet &clues) const {
+        for (const auto &set : unavoidable) {
+            if ((set & clues).none()) return &set;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Checks if the clues have a unique solution, learning a new unavoidable set if not
+     *
+     * @param clues cells of the solution that are given
+     * @param missed set to an unavoidable set without clues when not unique, may be empty
+     * @return true if the clues have a unique solution
+     */
+    bool isUnique(const clueSet &clues, clueSet &missed) {
+        missed.reset();
+        const clueSet *known = missedSet(clues);
+        if (known != nullptr) {
+            missed = *known;
+            return false;
+        }
+
+        Sudoku::puzzle first = {};
+        for (auto i = 0; i < Sudoku::SIZE * Sudoku::SIZE; i++) {
+            if (clues[i]) first[i / Sudoku::SIZE][i % Sudoku::SIZE] = solution[i / Sudoku::SIZE][i % Sudoku::SIZE];
+        }
+        Sudoku::puzzle second;
+        if (Sudoku::solve(first, second)) {
+            return true;
+        }
+        const Sudoku::puzzle &other = (first == solution) ? second : first;
+        for (auto i = 0; i < Sudoku::SIZE * Sudoku::SIZE; i++) {
+            if (other[i / Sudoku::SIZE][i % Sudoku::SIZE] != solution[i / Sudoku::SIZE][i % Sudoku::SIZE]) {
+                missed.set(i);
+            }
+        }
+        if (missed.any() && unavoidable.size() < MAX_UNAVOIDABLE) {
+            unavoidable.push_back(missed);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Removes clues in random order for as long as the solution stays unique
+     *
+     * @return true if any clue was removed
+     */
+    bool removeClues(clueSet &clues) {
+        std::vector<int> order;
+        for (auto i = 0; i < Sudoku::SIZE * Sudoku::SIZE; i++) {
+            if (clues[i]) order.push_back(i);
+        }
+        std::shuffle(order.begin(), order.end(), gen);
+        bool removed = false;
+        clueSet missed;
+        for (auto cell : order) {
+            clues.reset(cell);
+            if (isUnique(clues, missed)) {
+                removed = true;
+            }
+            else {
+                clues.set(cell);
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * @brief Replaces a random clue with a cell from an unavoidable set it leaves without clues
+     *
+     * @return true if the swap kept the solution unique
+     */
+    bool swapClue(clueSet &clues) {
+        std::vector<int> given;
+        for (auto i = 0; i < Sudoku::SIZE * Sudoku::SIZE; i++) {
+            if (clues[i]) given.push_back(i);
+        }
+        int out = given[gen() % given.size()];
+        clueSet candidate = clues;
+        candidate.reset(out);
+
+        clueSet missed;
+        if (isUnique(candidate, missed) || missed.none()) {
+            return false;
+        }
+        std::vector<int> choices;
+        for (auto i = 0; i < Sudoku::SIZE * Sudoku::SIZE; i++) {
+            if (missed[i] && i != out) choices.push_back(i);
+        }
+        if (choices.empty()) {
+            return false;
+        }
+        candidate.set(choices[gen() % choices.size()]);
+        if (!isUnique(candidate, missed)) {
+            return false;
+        }
+        clues = candidate;
+        return true;
+    }
+};
+
+/**
+ * @brief Searches for a puzzle with very few clues
+ *
+ * Every thread takes a random grid, removes clues until none can be
+ * removed, then swaps a clue for an empty cell and tries to remove clues
+ * again. After too many swaps without progress it starts over with a new
+ * grid. The puzzle with the fewest clues found by any thread is kept.
+ *
+ * @param clues number of clues wanted
+ * @param grid set to the puzzle with the fewest clues found, which has more
+ *             than clues clues when false is returned
+ * @param threads number of threads searching at the same time
+ * @param timeout give up after this many seconds, 0 to search until found
+ * @param stats number of grids tried and seconds spent searching
+ * @return true if a puzzle with at most the wanted number of clues was found
+ */
+bool Sudoku::generateSparse(int clues, puzzle &grid, unsigned threads, int timeout, searchStats &stats) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(timeout);
+    std::atomic<bool> found(false);
+    std::atomic<long> attempts(0);
+    std::mutex resultLock;
+    int bestClues = SIZE * SIZE + 1;
+
+    auto timedOut = [&]() {
+        return timeout > 0 && std::chrono::steady_clock::now() > deadline;
+    };
+
+    ThreadPool pool(threads);
+    pool.run(pool.size(), [&](std::size_t thread) {
+        std::random_device rd;
+        Climber climber;
+        climber.gen.seed(rd() + thread);
+        do {
+            climber.solution = {};
+            solve(climber.solution, true);
+            climber.unavoidable.clear();
+            attempts++;
+
+            clueSet given;
+            given.set();
+            climber.removeClues(given);
+
+            int stagnation = 0;
+            while (!found && !timedOut() && stagnation < STAGNATION_LIMIT && (int)given.count() > clues) {
+                if (climber.swapClue(given) && climber.removeClues(given)) {
+                    stagnation = 0;
+                }
+                else {
+                    stagnation++;
+                }
+            }
+
+            // Removing a batch may go below the wanted count, adding clues back keeps it unique
+            for (auto i = 0; (int)given.count() < clues && i < SIZE * SIZE; i++) {
+                given.set(i);
+            }
+
+            std::lock_guard<std::mutex> guard(resultLock);
+            if ((int)given.count() < bestClues) {
+                bestClues = given.count();
+                for (auto i = 0; i < SIZE * SIZE; i++) {
+                    grid[i / SIZE][i % SIZE] = given[i] ? climber.solution[i / SIZE][i % SIZE] : 0;
+                }
+            }
+            if (bestClues <= clues) {
+                found = true;
+            }
+        } while (!found && !timedOut());
+    });
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    stats.attempts = attempts;
+    stats.seconds = elapsed.count();
+    return found;
+}
@@ -1,24 +1,24 @@
 #include "Sudoku.h"
-#include <cmath>
+#include "Units.h"
 
-bool Sudoku::isSafe(puzzle grid, int row, int col, int num) {
-    // Checking in the box
-    const int box_size = sqrt(SIZE);
-    const int box_row = (row / box_size) * box_size;
-    const int box_col = (col / box_size) * box_size;
-
-    for (auto i = box_row; i < box_row + box_size; i++) {
-        for (auto j = box_col; j < box_col + box_size; j++) {
-            if (i == row && j == col) continue;
-            if (grid[i][j] == num) return false;
-        }
-    }
-
-    // Checking in rows and columns
-    for (auto i = 0; i < SIZE; i++) {
-        if (i != row && grid[i][col] == num) return false;
-        if (i != col && grid[row][i] == num) return false;
+bool Sudoku::isSafe(const puzzle &grid, int row, int col, int num) {
+    // Checking the row, column and box
+    for (auto peer : PEERS[row * SIZE + col]) {
+        if (grid[ROW_OF[peer]][COL_OF[peer]] == num) return false;
     }
 
     return true; // All checks passed
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Counts the empty squares of a puzzle
+ */
+int Sudoku::countEmpty(const puzzle &grid) {
+    int count = 0;
+    for (auto &row : grid) {
+        for (auto val : row) {
+            if (val == 0) count++;
+        }
+    }
+    return count;
+}
@@ -4,9 +4,26 @@
 namespace Sudoku {
     const int SIZE = 9;
     typedef std::array<std::array<int, SIZE>, SIZE> puzzle;
+    typedef std::array<std::array<bool, SIZE>, SIZE> mask;
+    struct searchStats {
+        long attempts;
+        double seconds;
+    };
     bool solve(puzzle &grid, bool randomize);
     bool solve(puzzle &grid);
+    bool solve(puzzle &grid, puzzle &second);
+    puzzle generate(int unknowns, unsigned threads, puzzle &solution);
+    puzzle generate(int unknowns, unsigned threads);
+    puzzle generate(int unknowns, puzzle &solution);
     puzzle generate(int unknowns);
     puzzle generate();
-    bool isSafe(puzzle grid, int row, int col, int val);
+    puzzle generateMinimal(unsigned threads, puzzle &solution);
+    puzzle generateMinimal(unsigned threads);
+    puzzle generateMinimal(puzzle &solution);
+    puzzle generateMinimal();
+    bool generateFromMask(const mask &clues, puzzle &grid, unsigned threads, int timeout, searchStats &stats);
+    bool generateSparse(int clues, puzzle &grid, unsigned threads, int timeout, searchStats &stats);
+    int countClues(const mask &clues);
+    int countEmpty(const puzzle &grid);
+    bool isSafe(const puzzle &grid, int row, int col, int val);
 }
\ No newline at end of file
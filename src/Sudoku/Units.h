@@ -0,0 +1,151 @@
+#pragma once
+#include "Sudoku.h"
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Lookup tables of the units and peers of every square
+ *
+ * Squares are numbered row * SIZE + col. Units are numbered with the rows
+ * first, then the columns and then the boxes, left to right and top to
+ * bottom. Everything is built at compile time.
+ */
+namespace Sudoku {
+    const int BOX_SIZE = 3;
+    const int CELLS = SIZE * SIZE;
+    const int UNITS = 3 * SIZE;
+    const int PEER_COUNT = 20;
+
+    const int ROW_UNIT = 0;
+    const int COL_UNIT = SIZE;
+    const int BOX_UNIT = 2 * SIZE;
+
+    /**
+     * @brief Set of squares, bit n is square n
+     */
+    struct cellSet {
+        std::uint64_t words[2];
+
+        constexpr void add(int cell) {
+            words[cell / 64] |= (std::uint64_t)1 << (cell % 64);
+        }
+        constexpr bool has(int cell) const {
+            return (words[cell / 64] & ((std::uint64_t)1 << (cell % 64))) != 0;
+        }
+        constexpr void remove(int cell) {
+            words[cell / 64] &= ~((std::uint64_t)1 << (cell % 64));
+        }
+        constexpr bool any() const {
+            return (words[0] | words[1]) != 0;
+        }
+        /**
+         * @brief Lowest square in the set, the set can not be empty
+         */
+        int first() const {
+            return words[0] != 0 ? __builtin_ctzll(words[0]) : 64 + __builtin_ctzll(words[1]);
+        }
+        int count() const {
+            return __builtin_popcountll(words[0]) + __builtin_popcountll(words[1]);
+        }
+        constexpr cellSet operator&(const cellSet &r) const {
+            return {{words[0] & r.words[0], words[1] & r.words[1]}};
+        }
+        constexpr cellSet operator|(const cellSet &r) const {
+            return {{words[0] | r.words[0], words[1] | r.words[1]}};
+        }
+        constexpr cellSet operator~() const {
+            return {{~words[0], ~words[1]}};
+        }
+        constexpr bool operator==(const cellSet &r) const {
+            return words[0] == r.words[0] && words[1] == r.words[1];
+        }
+    };
+
+    typedef std::array<std::uint8_t, CELLS> cellTable;
+    // Squares of every unit in order
+    typedef std::array<std::array<std::uint8_t, SIZE>, UNITS> unitTable;
+    // Row, column and box unit of every square, or its position in each of them
+    typedef std::array<std::array<std::uint8_t, 3>, CELLS> cellUnitTable;
+    typedef std::array<std::array<std::uint8_t, PEER_COUNT>, CELLS> peerTable;
+    typedef std::array<cellSet, CELLS> peerMaskTable;
+
+    constexpr int boxOf(int row, int col) {
+        return (row / BOX_SIZE) * BOX_SIZE + col / BOX_SIZE;
+    }
+
+    constexpr bool sees(int a, int b) {
+        return a != b && (a / SIZE == b / SIZE || a % SIZE == b % SIZE
+                          || boxOf(a / SIZE, a % SIZE) == boxOf(b / SIZE, b % SIZE));
+    }
+
+    constexpr cellTable makeRows() {
+        cellTable rows = {};
+        for (auto cell = 0; cell < CELLS; cell++) rows[cell] = cell / SIZE;
+        return rows;
+    }
+
+    constexpr cellTable makeCols() {
+        cellTable cols = {};
+        for (auto cell = 0; cell < CELLS; cell++) cols[cell] = cell % SIZE;
+        return cols;
+    }
+
+    constexpr unitTable makeUnitCells() {
+        unitTable units = {};
+        for (auto i = 0; i < SIZE; i++) {
+            for (auto j = 0; j < SIZE; j++) {
+                units[ROW_UNIT + i][j] = i * SIZE + j;
+                units[COL_UNIT + i][j] = j * SIZE + i;
+                int row = (i / BOX_SIZE) * BOX_SIZE + j / BOX_SIZE;
+                int col = (i % BOX_SIZE) * BOX_SIZE + j % BOX_SIZE;
+                units[BOX_UNIT + i][j] = row * SIZE + col;
+            }
+        }
+        return units;
+    }
+
+    constexpr cellUnitTable makeCellUnits(bool positions) {
+        cellUnitTable cells = {};
+        unitTable units = makeUnitCells();
+        for (auto unit = 0; unit < UNITS; unit++) {
+            for (auto pos = 0; pos < SIZE; pos++) {
+                int cell = units[unit][pos];
+                cells[cell][unit / SIZE] = positions ? pos : unit;
+            }
+        }
+        return cells;
+    }
+
+    constexpr peerTable makePeers() {
+        peerTable peers = {};
+        for (auto cell = 0; cell < CELLS; cell++) {
+            int count = 0;
+            for (auto other = 0; other < CELLS; other++) {
+                if (sees(cell, other)) peers[cell][count++] = other;
+            }
+        }
+        return peers;
+    }
+
+    constexpr peerMaskTable makePeerMasks() {
+        peerMaskTable masks = {};
+        for (auto cell = 0; cell < CELLS; cell++) {
+            for (auto other = 0; other < CELLS; other++) {
+                if (sees(cell, other)) masks[cell].add(other);
+            }
+        }
+        return masks;
+    }
+
+    inline constexpr cellTable ROW_OF = makeRows();
+    inline constexpr cellTable COL_OF = makeCols();
+    inline constexpr unitTable UNIT_CELLS = makeUnitCells();
+    inline constexpr cellUnitTable CELL_UNITS = makeCellUnits(false);
+    inline constexpr cellUnitTable UNIT_POSITIONS = makeCellUnits(true);
+    inline constexpr peerTable PEERS = makePeers();
+    inline constexpr peerMaskTable PEER_MASKS = makePeerMasks();
+
+    static_assert(CELL_UNITS[80][2] == BOX_UNIT + 8, "square 80 is in the last box");
+    static_assert(UNIT_CELLS[BOX_UNIT + 4][0] == 30, "the middle box starts at row 3 column 3");
+    static_assert(PEERS[0][PEER_COUNT - 1] == 72, "the last peer of square 0 is the bottom of its column");
+}
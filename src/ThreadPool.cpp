@@ -0,0 +1,110 @@
+#include "ThreadPool.h"
+#include <chrono>
+
+// Waits block until notified. They go through wait_until without a
+// deadline because GCC 12 links wait(unique_lock&) against a GLIBCXX_3.4.30
+// symbol, which older libstdc++ runtimes (up to 3.4.29) don't export.
+static const auto NO_DEADLINE = std::chrono::steady_clock::time_point::max();
+
+ThreadPool::ThreadPool() : ThreadPool(defaultThreads()) {
+}
+
+/**
+ * @brief Creates a pool that runs tasks on the given number of threads
+ *
+ * The thread calling run also executes tasks, so only threads - 1
+ * workers are started.
+ *
+ * @param threads total number of threads that execute tasks
+ */
+ThreadPool::ThreadPool(unsigned threads) {
+    task = nullptr;
+    next = 0;
+    count = 0;
+    finished = 0;
+    generation = 0;
+    stopping = false;
+    if (threads < 1) {
+        threads = 1;
+    }
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+unsigned ThreadPool::defaultThreads() {
+    unsigned threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+/**
+ * @brief Takes the next index of the current batch and runs it
+ *
+ * @param guard lock on the pool, released while the task runs
+ * @return true if a task was run
+ * @return false if every index of the batch has been handed out
+ */
+bool ThreadPool::runNext(std::unique_lock<std::mutex> &guard) {
+    if (task == nullptr || next >= count) {
+        return false;
+    }
+    std::size_t index = next++;
+    const std::function<void(std::size_t)> *func = task;
+    guard.unlock();
+    (*func)(index);
+    guard.lock();
+    if (++finished == count) {
+        done.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::work() {
+    std::unique_lock<std::mutex> guard(lock);
+    std::size_t seen = generation;
+    while (true) {
+        wake.wait_until(guard, NO_DEADLINE, [&] { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        while (runNext(guard)) {};
+    }
+}
+
+/**
+ * @brief Calls func once for every index in [0, tasks) and waits for all of them
+ *
+ * @param tasks number of indexes to run
+ * @param func called with each index, possibly from several threads at once
+ */
+void ThreadPool::run(std::size_t tasks, const std::function<void(std::size_t)> &func) {
+    if (tasks == 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> guard(lock);
+    task = &func;
+    next = 0;
+    count = tasks;
+    finished = 0;
+    generation++;
+    wake.notify_all();
+    while (runNext(guard)) {};
+    done.wait_until(guard, NO_DEADLINE, [&] { return finished == count; });
+    task = nullptr;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads that run indexed tasks in parallel
+ *
+ * The workers are kept alive between calls to run so that small batches
+ * of work do not pay for creating threads every time.
+ */
+class ThreadPool {
+    private:
+        std::vector<std::thread> workers;
+        std::mutex lock;
+        std::condition_variable wake;
+        std::condition_variable done;
+        const std::function<void(std::size_t)> *task;
+        std::size_t next;
+        std::size_t count;
+        std::size_t finished;
+        std::size_t generation;
+        bool stopping;
+
+        void work();
+        bool runNext(std::unique_lock<std::mutex> &guard);
+
+    public:
+        ThreadPool();
+        ThreadPool(unsigned threads);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        unsigned size() const;
+        void run(std::size_t tasks, const std::function<void(std::size_t)> &func);
+
+        static unsigned defaultThreads();
+};
@@ -316,7 +316,7 @@ void Window::printPencil() {
                 wmove(window, row, col);
                 int numbOfMarks = 0;
                 for (auto count = 0; count < 9; count++) {
-                    if ((marks[i][j] & (1u << count)) != 0) {
+                    if ((marks[i * Sudoku::SIZE + j] & (1u << count)) != 0) {
                         numbOfMarks++;
                         char c = START_CHAR + count;
                         if (!checkColors && c - START_CHAR - 1 == highlightNum && HIGHLIGHT_SELECTED) {
@@ -353,6 +353,24 @@ void Window::printInstructions() {
     mvwaddch(window, row + 2, col + 6, RIGHT_KEY);
     mvwaddch(window, row + 4, col + 3, DOWN_KEY);
     wattron(window, A_UNDERLINE);
+    mvwaddch(window, row + 6, col, UNDO_KEY);
+    wattroff(window, A_UNDERLINE);
+    if (UNDO_KEY == 'u' || UNDO_KEY == 'U') {
+        wprintw(window, "ndo");
+    }
+    else {
+        wprintw(window, " undo");
+    }
+    wattron(window, A_UNDERLINE);
+    mvwaddch(window, row + 7, col, REDO_KEY);
+    wattroff(window, A_UNDERLINE);
+    if (REDO_KEY == 'r' || REDO_KEY == 'R') {
+        wprintw(window, "edo");
+    }
+    else {
+        wprintw(window, " redo");
+    }
+    wattron(window, A_UNDERLINE);
     mvwaddch(window, row + 8, col, INSERT_KEY);
     wattroff(window, A_UNDERLINE);
     if (INSERT_KEY == 'i' || INSERT_KEY == 'I') {
@@ -462,7 +480,7 @@ int Window::getColor(char c, int row, int col) {
         return COLOR_PAIR(10);
     }
 
-    auto start = game->getStartGrid();
+    const auto &start = game->getStartGrid();
     int ret = 0;
     if (c == start[row][col] && c) {
         // Given square, underline it
@@ -484,13 +502,12 @@ int Window::getColor(char c, int row, int col) {
         return COLOR_PAIR(6) | ret;
     }
 
-    auto grid = game->getPlayGrid();
-    auto solution = game->getSolution();
-    if (checkColors && grid[row][col] == solution[row][col]) {
+    // Only asked when checking, it solves the puzzle the first time
+    if (checkColors && game->isCorrect(row, col)) {
         // Check colors is on and this is correct
         return COLOR_PAIR(2) | ret;
     }
-    if (checkColors && grid[row][col] != solution[row][col]) {
+    if (checkColors) {
         // Check colors is on and this is incorrect
         return COLOR_PAIR(1) | ret;
     }
@@ -625,7 +642,7 @@ void BigWindow::printPencil() {
                 }
                 */
                 for (char c = START_CHAR; c <= START_CHAR+8; c++) {
-                    printPencil(c, row, col, marks[i][j]);
+                    printPencil(c, row, col, marks[i * Sudoku::SIZE + j]);
                 }
             }
             col += 8;
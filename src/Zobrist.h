@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Sudoku/Units.h"
+
+/**
+ * @brief Random keys for hashing board positions
+ *
+ * The hash of a position is every key of its placed digits and of the
+ * pencil marks of its empty squares xored together, so a change only
+ * xors in the keys of what changed. The keys are made at compile time so
+ * hashes are the same in every run.
+ */
+namespace Zobrist {
+    // [square][digit - 1]
+    typedef std::array<std::array<std::uint64_t, Sudoku::SIZE>, Sudoku::CELLS> keyTable;
+
+    constexpr std::uint64_t splitmix(std::uint64_t &state) {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    constexpr keyTable makeKeys(std::uint64_t seed) {
+        keyTable keys = {};
+        for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+            for (auto digit = 0; digit < Sudoku::SIZE; digit++) {
+                keys[cell][digit] = splitmix(seed);
+            }
+        }
+        return keys;
+    }
+
+    inline constexpr keyTable DIGITS = makeKeys(1);
+    inline constexpr keyTable MARKS = makeKeys(2);
+}
@@ -42,6 +42,8 @@ enum keybinds {
     TOGGLE_KEY =  27, // 27 = ESC. Switches between incert and pencil
     AUTO_PENCIL_KEY = 'a',
     HINT_KEY = '?',
+    UNDO_KEY = 'u',
+    REDO_KEY = 'r',
 };
 
 // Colors
@@ -117,3 +119,4 @@ static const bool START_TIMER = true;
 static const bool REMOVE_MARKS = true;
 static const bool HIGHLIGHT_SELECTED = true;
 static const bool DIM_COMPLETED = true;
+static const int GENERATE_TIMEOUT = 60; // Seconds to search for a puzzle matching a mask or a sparse one
@@ -2,17 +2,26 @@
 #include "File.h"
 #include "Arguments.h"
 #include "Sudoku/Sudoku.h"
+#include "Sudoku/Packed.h"
 #include "config.h"
 #include "HumanSolve.h"
+#include "ThreadPool.h"
+#include "Database.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <map>
 #include <unistd.h>
 
-void generate(int, bool, std::string);
+void generate(int, bool, std::string, bool);
+void generateMask(std::string);
+void generateDatabase(std::string, int, int, bool);
 void solve(bool, std::string);
-void play(bool, std::string, int, bool);
+void play(bool, std::string, int, bool, bool);
+void playDatabase(std::string, int, int, bool);
+void playBoard(Board &, bool);
 void test(bool, std::string, int, bool);
+void grade(std::string, int, bool, bool);
 void startCurses();
 void endCurses();
 WINDOW * createWindow();
@@ -27,15 +36,30 @@ int main(int argc, char *argv[]) {
     }
     switch(args.getFeature()) {
         case feature::Generate:
-        generate(args.getArgInt(), args.fileArgSet(), args.getFileName());
+        if (args.maskArgSet()) {
+            generateMask(args.getFileName());
+            break;
+        }
+        if (args.databaseArgSet()) {
+            generateDatabase(args.getDatabase(), args.getCount(), args.getArgInt(), args.minimal());
+            break;
+        }
+        generate(args.getArgInt(), args.fileArgSet(), args.getFileName(), args.minimal());
         break;
         case feature::Solve:
         solve(args.fileArgSet(), args.getFileName());
         break;
         case feature::Play:
-        play(args.fileArgSet(), args.getFileName(), args.getArgInt(), args.bigBoard());
+        if (args.databaseArgSet()) {
+            playDatabase(args.getDatabase(), args.getArgInt(), args.getTier(), args.bigBoard());
+            break;
+        }
+        play(args.fileArgSet(), args.getFileName(), args.getArgInt(), args.bigBoard(), args.minimal());
         //test(args.fileArgSet(), args.getFileName(), args.getArgInt(), args.bigBoard());
         break;
+        case feature::Grading:
+        grade(args.getGradeFile(), args.getJobs(), args.json(), args.allSingles());
+        break;
     }
 }
 
@@ -57,16 +81,7 @@ WINDOW * createWindow() {
 }
 
 Board makeNotSimpleBoard(SimpleBoard &board) {
-    Sudoku::puzzle grid = board.getPlayGrid();
-    std::stringstream gridStringStream;
-    for (size_t i = 0; i < grid.size(); i++) {
-        for (size_t j = 0; j < grid[i].size(); j++) {
-            gridStringStream << grid[i][j];
-        }
-    }
-    Sudoku::puzzle sol = grid;
-    Sudoku::solve(sol);
-    return Board(grid, sol);
+    return Board(board.getPlayGrid());
 }
 
 Board selectBoard(std::vector<SimpleBoard> boards) {
@@ -84,9 +99,14 @@ Board selectBoard(std::vector<SimpleBoard> boards) {
 }
 
 
-void generate(int empty, bool file, std::string fileName) {
+void generate(int empty, bool file, std::string fileName, bool minimal) {
     //Generator gen = (empty) ? Generator(empty) : Generator();
-    SimpleBoard board = Sudoku::generate(empty);
+    Sudoku::puzzle grid = minimal ? Sudoku::generateMinimal() : Sudoku::generate(empty);
+    if (Sudoku::countEmpty(grid) < empty) {
+        std::cerr << "Could only find a puzzle with " << Sudoku::countEmpty(grid) << " of the "
+                  << empty << " empty squares asked for.\n";
+    }
+    SimpleBoard board(grid);
     if (file) {
         std::ofstream fileStream;
         fileStream.open(fileName);
@@ -98,6 +118,173 @@ void generate(int empty, bool file, std::string fileName) {
     return;
 }
 
+void generateMask(std::string mask) {
+    Sudoku::mask clues;
+    if (!file::getMask(mask.c_str(), clues)) {
+        std::cout << "A mask has to have exactly 81 squares.\n";
+        return;
+    }
+    Sudoku::puzzle grid;
+    Sudoku::searchStats stats;
+    bool found = Sudoku::generateFromMask(clues, grid, ThreadPool::defaultThreads(), GENERATE_TIMEOUT, stats);
+    if (found) {
+        SimpleBoard(grid).printBoard();
+    }
+    else {
+        std::cout << "Could not find a puzzle with " << Sudoku::countClues(clues) << " clues matching the mask.\n";
+    }
+    std::cout << "Attempts: " << stats.attempts << " in " << stats.seconds << "s ("
+              << (stats.seconds > 0 ? stats.attempts / stats.seconds : 0) << " per second)" << std::endl;
+}
+
+/**
+ * @brief Generates puzzles, grades them and adds them to a database
+ * 
+ * @param database file name of the database
+ * @param count number of puzzles to generate
+ * @param empty number of empty squares, 0 for the default
+ * @param minimal generate puzzles where no clue can be removed
+ */
+void generateDatabase(std::string database, int count, int empty, bool minimal) {
+    PuzzleDatabase db(database);
+    if (!db.isValid()) {
+        std::cout << database << " is not a puzzle database.\n";
+        return;
+    }
+    int added = 0;
+    int fewer = 0;
+    for (auto i = 0; i < count; i++) {
+        Sudoku::puzzle solution;
+        Sudoku::puzzle puzzle = minimal ? Sudoku::generateMinimal(solution) : Sudoku::generate(empty, solution);
+        if (Sudoku::countEmpty(puzzle) < empty) {
+            fewer++;
+        }
+        Board board(puzzle, solution);
+        board.autoPencil();
+        Grade grade = gradeHuman(board);
+        if (db.append(puzzle, solution, grade.difficulty)) {
+            added++;
+        }
+    }
+    std::cout << "Added " << added << " of " << count << " puzzles to " << database
+              << ", it now holds " << db.size() << ".\n";
+    if (fewer > 0) {
+        std::cerr << fewer << " of them have fewer than the " << empty << " empty squares asked for.\n";
+    }
+}
+
+/**
+ * @brief Grades puzzles on a thread pool and prints a line for each
+ */
+class Grader {
+    private:
+        ThreadPool pool;
+        bool json;
+        bool allSingles;
+        long index;
+        long solved;
+        std::map<int, long> histogram;
+
+    public:
+        Grader(unsigned jobs, bool json, bool allSingles) : pool(jobs), json(json), allSingles(allSingles), index(0), solved(0) {
+            if (!json) {
+                std::cout << "index,puzzle,tier,moves,solved\n";
+            }
+        }
+
+        /**
+         * @brief Grades the puzzles in parallel and prints them in order
+         */
+        void grade(const std::vector<Sudoku::packed> &puzzles) {
+            std::vector<Grade> grades(puzzles.size());
+            pool.run(puzzles.size(), [&](std::size_t i) {
+                Board board(Sudoku::unpack(puzzles[i]));
+                board.autoPencil();
+                grades[i] = gradeHuman(board, allSingles);
+            });
+
+            for (std::size_t i = 0; i < puzzles.size(); i++) {
+                std::string puzzle;
+                for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+                    puzzle += (char)(puzzles[i].get(cell) + '0');
+                }
+                const Grade &grade = grades[i];
+                if (json) {
+                    std::cout << "{\"index\": " << index << ", \"puzzle\": \"" << puzzle << "\", \"tier\": " << grade.difficulty
+                              << ", \"moves\": " << grade.moves << ", \"solved\": " << (grade.solved ? "true" : "false") << "}\n";
+                }
+                else {
+                    std::cout << index << ',' << puzzle << ',' << grade.difficulty << ',' << grade.moves << ',' << grade.solved << '\n';
+                }
+                index++;
+                solved += grade.solved;
+                histogram[grade.difficulty]++;
+            }
+            std::cout << std::flush;
+        }
+
+        void printHistogram(std::ostream &stream) const {
+            stream << "tier\tpuzzles\n";
+            for (auto &tier : histogram) {
+                stream << tier.first << '\t' << tier.second << '\n';
+            }
+            stream << "Solved " << solved << " of " << index << " puzzles." << std::endl;
+        }
+};
+
+/**
+ * @brief Grades every puzzle in a file, or in standard input when the file is -
+ * 
+ * Standard input is read one puzzle per line, in the characters an SDK
+ * file uses, and graded in batches as the lines come in. Other lines are
+ * skipped.
+ * 
+ * @param fileName file with the puzzles or -
+ * @param jobs number of threads, 0 for every core
+ * @param json print JSON lines instead of CSV
+ * @param allSingles place every single at once, see HumanSolver::grade
+ */
+void grade(std::string fileName, int jobs, bool json, bool allSingles) {
+    const std::size_t BATCH_SIZE = 1024;
+    if (fileName != "-" && !std::ifstream(fileName).good()) {
+        std::cout << "Could not read " << fileName << ".\n";
+        return;
+    }
+    Grader grader(jobs > 0 ? jobs : ThreadPool::defaultThreads(), json, allSingles);
+    if (fileName != "-") {
+        std::vector<Sudoku::packed> puzzles;
+        for (const auto &board : file::getPuzzle(fileName.c_str())) {
+            puzzles.push_back(Sudoku::pack(board.getPlayGrid()));
+        }
+        grader.grade(puzzles);
+        grader.printHistogram(std::cerr);
+        return;
+    }
+
+    std::vector<Sudoku::packed> batch;
+    std::string line;
+    while (getline(std::cin, line)) {
+        if (line.empty() || line.front() == '#') continue;
+        std::string puzzle;
+        for (char c : line) {
+            if ('1' <= c && '9' >= c) {
+                puzzle += c;
+            }
+            else if ('.' == c || 'X' == c || '0' == c || 'x' == c) {
+                puzzle += '0';
+            }
+        }
+        if (puzzle.size() != 81) continue;
+        batch.push_back(Sudoku::pack(puzzle));
+        if (batch.size() == BATCH_SIZE) {
+            grader.grade(batch);
+            batch.clear();
+        }
+    }
+    grader.grade(batch);
+    grader.printHistogram(std::cerr);
+}
+
 void solve(bool file, std::string fileName) {
     if (file) {
         selectBoard(file::getPuzzle(fileName.c_str())).printSolution();
@@ -126,7 +313,7 @@ void solve(bool file, std::string fileName) {
     return;
 }
 
-Board createBoard(bool file, std::string fileName, int empty) {
+Board createBoard(bool file, std::string fileName, int empty, bool minimal) {
     if (file) {
         return selectBoard(file::getPuzzle(fileName.c_str()));
     }
@@ -134,12 +321,46 @@ Board createBoard(bool file, std::string fileName, int empty) {
         // no file attempting to get string board from fileName
         return selectBoard(file::getStringPuzzle(fileName.c_str()));
     }
-    return Board(Sudoku::generate(empty));
+    Sudoku::puzzle solution;
+    if (minimal) {
+        Sudoku::puzzle grid = Sudoku::generateMinimal(solution);
+        return Board(grid, solution);
+    }
+    Sudoku::puzzle grid = Sudoku::generate(empty, solution);
+    return Board(grid, solution);
+}
+
+void play(bool file, std::string fileName, int empty, bool big, bool minimal) {
+    startCurses();
+    Board b = createBoard(file, fileName, empty, minimal);
+    playBoard(b, big);
 }
 
-void play(bool file, std::string fileName, int empty, bool big) {
+/**
+ * @brief Plays a random puzzle from a database
+ * 
+ * @param database file name of the database
+ * @param empty number of empty squares, 0 for any
+ * @param tier difficulty tier, negative for any
+ * @param big use the big board
+ */
+void playDatabase(std::string database, int empty, int tier, bool big) {
+    PuzzleDatabase db(database);
+    PuzzleDatabase::entry entry;
+    if (!db.isValid()) {
+        std::cout << database << " is not a puzzle database.\n";
+        return;
+    }
+    if (!db.random(empty ? empty : PuzzleDatabase::ANY, tier < 0 ? PuzzleDatabase::ANY : tier, entry)) {
+        std::cout << "No puzzle in " << database << " matches.\n";
+        return;
+    }
     startCurses();
-    Board b = createBoard(file, fileName, empty);
+    Board b(entry.puzzle, entry.solution);
+    playBoard(b, big);
+}
+
+void playBoard(Board &b, bool big) {
     Window *win = big ? new BigWindow(&b, createWindow()) : new Window(&b, createWindow());
     Game game(win, big);
     int playTime = game.mainLoop();
@@ -0,0 +1,52 @@
+#include "GenerateLatency.h"
+#include "../src/Sudoku/Sudoku.h"
+#include "../src/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Gets the value below which the given fraction of samples fall
+ *
+ * @param samples sorted latencies
+ * @param fraction between 0 and 1
+ * @return double the latency at that percentile
+ */
+static double percentile(const std::vector<double> &samples, double fraction) {
+    std::size_t idx = fraction * (samples.size() - 1) + 0.5;
+    return samples[idx];
+}
+
+/**
+ * @brief Times single puzzle generation with every thread count up to the core count
+ *
+ * Puzzles are generated with as many empty cells as possible since that
+ * is where the most removals are tested.
+ *
+ * @param count number of puzzles generated per thread count
+ */
+void measureGenerateLatency(int count) {
+    unsigned cores = ThreadPool::defaultThreads();
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    std::cout << "threads\tp50 (ms)\tp99 (ms)\n";
+    for (auto threads : threadCounts) {
+        std::vector<double> samples;
+        for (auto i = 0; i < count; i++) {
+            auto start = std::chrono::steady_clock::now();
+            Sudoku::generate(0, threads);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            samples.push_back(elapsed.count());
+        }
+        std::sort(samples.begin(), samples.end());
+        std::cout << threads << '\t' << std::fixed << std::setprecision(3)
+                  << percentile(samples, 0.5) << '\t' << percentile(samples, 0.99) << '\n';
+    }
+    std::cout << std::endl;
+}
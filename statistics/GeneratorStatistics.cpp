@@ -1,5 +1,5 @@
 #include "GeneratorStatistics.h"
-#include "../src/Generator.h"
+#include "../src/Sudoku/Sudoku.h"
 #include "../src/HumanSolve.h"
 #include <iostream>
 
@@ -20,21 +20,11 @@ SingleStats gradeBoard(Board &board) {
     SingleStats stats = {};
     stats.emptyGrids = countEmptyCells(board);
 
-    Hint hint = solveHuman(board);
-
     std::cout << "--> Solving board " << count << '\n';
-    while(hint.moves.size() > 0) {
-        if (hint.difficulty > stats.difficulty) {
-            stats.difficulty = hint.difficulty;
-        }
-        for (auto &move : hint.moves) {
-            move(&board);
-            stats.movesToSolve++;
-        }
-        hint = solveHuman(board);
-    }
-    if (board.getPlayGrid() != board.getSolution()) {
-        stats.difficulty = hint.difficulty;
+    Grade grade = gradeHuman(board);
+    stats.difficulty = grade.difficulty;
+    stats.movesToSolve = grade.moves;
+    if (!grade.solved) {
         std::cout << "---> Did not solve\n";
     }
     std::cout << "---> Difficulty " << stats.difficulty << '\n';
@@ -50,7 +40,7 @@ void accumulateBoardGrades(int count) {
 
     for (auto i = 0; i < count; i++) {
         std::cout << "\nGenerating board " << i + 1 << '\n';
-        Board board = Generator().createBoard();
+        Board board = Board(Sudoku::generate());
         board.autoPencil();
         auto stats = gradeBoard(board);
         cum_difficulty += stats.difficulty;
@@ -1,23 +1,24 @@
 #include "HumanSolverPercentage.h"
 #include "../src/HumanSolve.h"
-#include "../src/Generator.h"
+#include "../src/Sudoku/Sudoku.h"
 #include <iostream>
 #include <chrono>
 #include <ctime>
 
 bool HumanSolveUntilFailed(Board &board) {
-    Hint hint = solveHuman(board);
+    HumanSolver solver(board);
+    Hint hint = solver.nextHint();
 
     // get the hint and make the moves until there are none left
     while(hint.moves.size() > 0) {
         for (auto &move : hint.moves) {
             move(&board);
         }
-        hint = solveHuman(board);
+        hint = solver.nextHint();
     }
 
-    puzzle grid = board.getPlayGrid();
-    puzzle sol = board.getSolution();
+    Sudoku::puzzle grid = board.getPlayGrid();
+    Sudoku::puzzle sol = board.getSolution();
     return grid == sol;
 }
 
@@ -26,7 +27,7 @@ void getSolvedPercentage(int count) {
     for (auto i = 0; i < count; i++) {
         std::cout << "Generating board " << i + 1 << '\n';
         auto start_gen = std::chrono::system_clock::now();
-        Board board = Generator().createBoard();
+        Board board = Board(Sudoku::generate());
         auto end_gen = std::chrono::system_clock::now();
         std::chrono::duration<double> elapsed_gen = end_gen - start_gen;
         std::cout << "--> Took: " << elapsed_gen.count() << "s\n";
@@ -0,0 +1,46 @@
+#include "TechniqueProfile.h"
+#include "../src/HumanSolve.h"
+#include "../src/Profile.h"
+#include "../src/ThreadPool.h"
+#include "../src/Sudoku/Sudoku.h"
+#include "../src/Sudoku/Packed.h"
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Grades generated boards and prints what every technique cost
+ *
+ * The puzzles are generated first and kept packed, then graded in
+ * parallel, so the profile only holds the grading.
+ *
+ * @param count number of boards to grade
+ * @param json print JSON instead of a table
+ */
+void profileTechniques(int count, bool json) {
+    if (!Profile::ENABLED) {
+        std::cerr << "Profiling is compiled out, configure with -DTUIDOKU_PROFILE=ON\n";
+        return;
+    }
+
+    std::vector<Sudoku::packed> puzzles;
+    for (auto i = 0; i < count; i++) {
+        puzzles.push_back(Sudoku::pack(Sudoku::generate()));
+    }
+
+    Profile::reset();
+    ThreadPool pool;
+    pool.run(puzzles.size(), [&](std::size_t i) {
+        Board board(Sudoku::unpack(puzzles[i]));
+        board.autoPencil();
+        gradeHuman(board);
+    });
+
+    Profile::table counts = Profile::collect();
+    if (json) {
+        Profile::printJson(counts, std::cout);
+    }
+    else {
+        Profile::printTable(counts, std::cout);
+    }
+    std::cout << std::flush;
+}
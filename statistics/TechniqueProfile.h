@@ -0,0 +1,3 @@
+#pragma once
+
+void profileTechniques(int count, bool json);
@@ -1,5 +1,7 @@
 #include "HumanSolverPercentage.h"
 #include "GeneratorStatistics.h"
+#include "GenerateLatency.h"
+#include "TechniqueProfile.h"
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -18,4 +20,13 @@ int main(int argc, char *argv[]) {
     if (acc_board_grades != args.end()) {
         accumulateBoardGrades(stoi(*(acc_board_grades + 1)));
     }
+    auto generate_latency = std::find(args.begin(), args.end(), "generate_latency");
+    if (generate_latency != args.end()) {
+        measureGenerateLatency(stoi(*(generate_latency + 1)));
+    }
+    auto profile_techniques = std::find(args.begin(), args.end(), "profile_techniques");
+    if (profile_techniques != args.end()) {
+        bool json = std::find(args.begin(), args.end(), "json") != args.end();
+        profileTechniques(stoi(*(profile_techniques + 1)), json);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "../src/HumanSolve.h"
+
+// Counts every allocation made by the test binary
+static std::atomic<long> allocations(0);
+
+void *operator new(std::size_t size) {
+    allocations++;
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+/**
+ * @brief Grading a board should not allocate anything
+ * 
+ * The boards are solved with everything from singles to X-wings and one
+ * of them gets stuck, so every technique gets to run.
+ */
+TEST(Allocation_test, gradeHuman) {
+    const char *grids[] = {
+        "009032000000700000162000000010020560000900000050000107000000403026009000005870000",
+        "041729030769003402032640719403900170607004903195370024214567398376090541958431267",
+        "798452316603781092012030870370265048820143760060897023980014237107028050200070081",
+        "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+    };
+    for (auto grid : grids) {
+        long start = allocations;
+        Board board(grid);
+        board.autoPencil();
+        // the board itself allocates, which shows the counting works
+        ASSERT_GT(allocations - start, 0);
+        long before = allocations;
+        Grade grade = gradeHuman(board);
+        long after = allocations;
+        EXPECT_EQ(after - before, 0) << grid;
+        EXPECT_GT(grade.moves, 0) << grid;
+    }
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "../src/Candidates.h"
+#include <random>
+
+/**
+ * @brief The kernels in use have to find the same squares as the scalar ones
+ *
+ * Marks are random so every square, the last one on its own included, gets
+ * every count of marks.
+ */
+TEST(Candidates_test, sameAsScalar) {
+    std::mt19937 rng(50);
+    std::uint16_t marks[Sudoku::CELLS];
+    for (auto round = 0; round < 200; round++) {
+        for (auto &square : marks) {
+            square = rng() & ((1u << 9) - 1);
+        }
+        if (round % 2 == 0) {
+            marks[Sudoku::CELLS - 1] = 0x1FF;
+        }
+        for (auto count = 0; count <= 9; count++) {
+            ASSERT_EQ(Candidates::withCount(marks, count), Candidates::Scalar::withCount(marks, count));
+            ASSERT_EQ(Candidates::withMoreThan(marks, count), Candidates::Scalar::withMoreThan(marks, count));
+        }
+    }
+}
+
+TEST(Candidates_test, squares) {
+    std::uint16_t marks[Sudoku::CELLS] = {};
+    marks[0] = 0x003;
+    marks[17] = 0x002;
+    marks[64] = 0x105;
+    marks[80] = 0x1F5;
+
+    Sudoku::cellSet expected = {};
+    expected.add(0);
+    EXPECT_EQ(Candidates::withCount(marks, 2), expected);
+
+    expected = {};
+    expected.add(64);
+    expected.add(80);
+    EXPECT_EQ(Candidates::withMoreThan(marks, 2), expected);
+    expected.remove(80);
+    EXPECT_EQ(Candidates::withCount(marks, 3), expected);
+
+    expected = {};
+    expected.add(80);
+    EXPECT_EQ(Candidates::withMoreThan(marks, 4), expected);
+    EXPECT_FALSE(Candidates::withMoreThan(marks, 7).any());
+}
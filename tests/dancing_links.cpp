@@ -1,7 +1,10 @@
 #include "dancing_links.h"
 #include "../src/config.h"
+#include "../src/Sudoku/Units.h"
+#include "../src/Sudoku/Packed.h"
 #include <gtest/gtest.h>
 #include <sstream>
+#include <algorithm>
 
 void GenerateBoard(std::string puzzleString, std::string solutionString, Sudoku::puzzle &grid, Sudoku::puzzle &solution) {
     for (auto i = 0; i < Sudoku::SIZE; i++) {
@@ -104,6 +107,20 @@ TEST(dancingLinks, generate_then_solve) {
     }
 }
 
+TEST(dancingLinks, generate_with_solution) {
+    for (auto unknowns : {30, 50}) {
+        Sudoku::puzzle solution;
+        Sudoku::puzzle grid = Sudoku::generate(unknowns, solution);
+        Sudoku::puzzle solved = grid;
+        EXPECT_TRUE(Sudoku::solve(solved, false));
+        EXPECT_EQ(solution, solved);
+    }
+    Sudoku::puzzle solution;
+    Sudoku::puzzle grid = Sudoku::generateMinimal(solution);
+    Sudoku::solve(grid, false);
+    EXPECT_EQ(solution, grid);
+}
+
 TEST(dancingLinks, generate_numb_of_unknowns) {
     for (auto unknowns = 1; unknowns < 60; unknowns++) {
         Sudoku::puzzle grid = Sudoku::generate(unknowns);
@@ -120,9 +137,156 @@ TEST(dancingLinks, generate_numb_of_unknowns) {
     }
 }
 
+TEST(dancingLinks, generate_numb_of_unknowns_threaded) {
+    for (auto unknowns = 10; unknowns < 60; unknowns += 7) {
+        Sudoku::puzzle grid = Sudoku::generate(unknowns, 4);
+        auto un = 0;
+        for (auto &i : grid) {
+            for (auto &j : i) {
+                if (j == 0) {
+                    un++;
+                }
+            }
+        }
+        EXPECT_EQ(un, unknowns);
+        Sudoku::puzzle solved = grid;
+        EXPECT_TRUE(Sudoku::solve(solved, false));
+    }
+}
+
 TEST(dancingLinks, generate_not_too_slow) {
     for (auto i = 0; i < 0xFF; i++) {
         Sudoku::puzzle grid = Sudoku::generate();
         printBoard(grid, std::cout);
     }
-}
\ No newline at end of file
+}
+TEST(dancingLinks, generate_minimal) {
+    for (auto threads = 1u; threads <= 4; threads++) {
+        Sudoku::puzzle grid = Sudoku::generateMinimal(threads);
+        Sudoku::puzzle solved = grid;
+        EXPECT_TRUE(Sudoku::solve(solved, false));
+        for (auto i = 0; i < Sudoku::SIZE; i++) {
+            for (auto j = 0; j < Sudoku::SIZE; j++) {
+                if (grid[i][j] == 0) continue;
+                Sudoku::puzzle removed = grid;
+                removed[i][j] = 0;
+                EXPECT_FALSE(Sudoku::solve(removed, false)) << "Clue at " << i << ' ' << j << " is not necessary";
+            }
+        }
+        printBoard(grid, std::cout);
+    }
+}
+
+TEST(dancingLinks, generate_from_mask) {
+    const char *maskString = "..XX..X.X..X..X..X.X..X..XX..X..X.XXXX...XX...X..XX...X.....X.X..XX.XXX..XXXX.X..";
+    Sudoku::mask clues;
+    for (auto i = 0; i < Sudoku::SIZE * Sudoku::SIZE; i++) {
+        clues[i / Sudoku::SIZE][i % Sudoku::SIZE] = maskString[i] == 'X';
+    }
+
+    Sudoku::puzzle grid;
+    Sudoku::searchStats stats;
+    ASSERT_TRUE(Sudoku::generateFromMask(clues, grid, 2, 60, stats));
+    EXPECT_GT(stats.attempts, 0);
+    for (auto i = 0; i < Sudoku::SIZE; i++) {
+        for (auto j = 0; j < Sudoku::SIZE; j++) {
+            EXPECT_EQ(grid[i][j] != 0, clues[i][j]);
+        }
+    }
+    Sudoku::puzzle solved = grid;
+    EXPECT_TRUE(Sudoku::solve(solved, false));
+    printBoard(grid, std::cout);
+}
+
+TEST(dancingLinks, generate_from_mask_too_few_clues) {
+    Sudoku::mask clues = {};
+    for (auto i = 0; i < Sudoku::SIZE; i++) {
+        clues[i][i] = true;
+    }
+    Sudoku::puzzle grid;
+    Sudoku::searchStats stats;
+    EXPECT_FALSE(Sudoku::generateFromMask(clues, grid, 2, 1, stats));
+    EXPECT_EQ(stats.attempts, 0);
+}
+
+TEST(dancingLinks, generate_sparse) {
+    for (auto clues = 22; clues >= 20; clues--) {
+        Sudoku::puzzle grid;
+        Sudoku::searchStats stats;
+        ASSERT_TRUE(Sudoku::generateSparse(clues, grid, 2, 120, stats));
+        auto given = 0;
+        for (auto &i : grid) {
+            for (auto &j : i) {
+                if (j != 0) {
+                    given++;
+                }
+            }
+        }
+        EXPECT_EQ(given, clues);
+        EXPECT_EQ(Sudoku::countEmpty(grid), Sudoku::SIZE * Sudoku::SIZE - clues);
+        Sudoku::puzzle solved = grid;
+        EXPECT_TRUE(Sudoku::solve(solved, false));
+        printBoard(grid, std::cout);
+    }
+}
+
+TEST(dancingLinks, solve_second_solution) {
+    Sudoku::puzzle grid = {};
+    Sudoku::puzzle second;
+    EXPECT_FALSE(Sudoku::solve(grid, second));
+    EXPECT_NE(grid, second);
+    EXPECT_EQ(std::count(second[0].begin(), second[0].end(), 0), 0);
+}
+
+TEST(dancingLinks, unit_tables) {
+    for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+        int row = Sudoku::ROW_OF[cell];
+        int col = Sudoku::COL_OF[cell];
+        EXPECT_EQ(Sudoku::CELL_UNITS[cell][0], Sudoku::ROW_UNIT + row);
+        EXPECT_EQ(Sudoku::CELL_UNITS[cell][1], Sudoku::COL_UNIT + col);
+        EXPECT_EQ(Sudoku::CELL_UNITS[cell][2], Sudoku::BOX_UNIT + (row / 3) * 3 + col / 3);
+        for (auto i = 0; i < 3; i++) {
+            EXPECT_EQ(Sudoku::UNIT_CELLS[Sudoku::CELL_UNITS[cell][i]][Sudoku::UNIT_POSITIONS[cell][i]], cell);
+        }
+
+        // every peer shares a unit and is in the mask, nothing else is
+        int peers = 0;
+        for (auto other = 0; other < Sudoku::CELLS; other++) {
+            bool shares = false;
+            for (auto i = 0; i < 3; i++) {
+                shares |= Sudoku::CELL_UNITS[cell][i] == Sudoku::CELL_UNITS[other][i];
+            }
+            shares &= other != cell;
+            EXPECT_EQ(Sudoku::PEER_MASKS[cell].has(other), shares);
+            if (shares) {
+                EXPECT_EQ(Sudoku::PEERS[cell][peers++], other);
+            }
+        }
+        EXPECT_EQ(peers, Sudoku::PEER_COUNT);
+    }
+}
+
+TEST(dancingLinks, packed_grid) {
+    Sudoku::puzzle solution;
+    Sudoku::puzzle grid = Sudoku::generate(40, solution);
+    for (const auto &original : {grid, solution}) {
+        Sudoku::packed packed = Sudoku::pack(original);
+        EXPECT_EQ(Sudoku::unpack(packed), original);
+        for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+            EXPECT_EQ(packed.get(cell), original[Sudoku::ROW_OF[cell]][Sudoku::COL_OF[cell]]);
+        }
+    }
+    EXPECT_NE(Sudoku::pack(grid), Sudoku::pack(solution));
+
+    std::string squares = "980062753065003000327050006790030500050009000832045009673591428249087005518020007";
+    Sudoku::packed packed = Sudoku::pack(squares);
+    EXPECT_EQ(packed.get(0, 0), 9);
+    EXPECT_EQ(packed.get(8, 8), 7);
+    EXPECT_EQ(packed.get(8, 7), 0);
+    packed.set(8, 7, 6);
+    packed.set(8, 8, 0);
+    EXPECT_EQ(packed.get(8, 7), 6);
+    EXPECT_EQ(packed.get(8, 8), 0);
+    EXPECT_EQ(packed.get(8, 6), 0);
+    EXPECT_EQ(sizeof(Sudoku::packed), 41u);
+}
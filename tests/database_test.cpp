@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include "../src/Database.h"
+
+/**
+ * @brief Creates an empty database file name in the test temp directory
+ */
+static std::string tempDatabase(std::string name) {
+    std::string fileName = ::testing::TempDir() + name;
+    std::remove(fileName.c_str());
+    std::remove((fileName + ".idx").c_str());
+    return fileName;
+}
+
+/**
+ * @brief Adds puzzles with 40 to 40 + count - 1 empty cells, tier is empty cells % 3
+ */
+static void fill(PuzzleDatabase &db, int count) {
+    for (auto i = 0; i < count; i++) {
+        Sudoku::puzzle puzzle = Sudoku::generate(40 + i);
+        Sudoku::puzzle solution = puzzle;
+        Sudoku::solve(solution);
+        ASSERT_TRUE(db.append(puzzle, solution, (40 + i) % 3));
+    }
+}
+
+TEST(DatabaseTest, appendAndReopen) {
+    std::string fileName = tempDatabase("tuidoku_reopen.db");
+    {
+        PuzzleDatabase db(fileName);
+        ASSERT_TRUE(db.isValid());
+        EXPECT_EQ(db.size(), 0);
+        fill(db, 6);
+        EXPECT_EQ(db.size(), 6);
+    }
+    PuzzleDatabase db(fileName);
+    ASSERT_TRUE(db.isValid());
+    EXPECT_EQ(db.size(), 6);
+    EXPECT_EQ(db.count(PuzzleDatabase::ANY, PuzzleDatabase::ANY), 6);
+    EXPECT_EQ(db.count(42, PuzzleDatabase::ANY), 1);
+    EXPECT_EQ(db.count(PuzzleDatabase::ANY, 0), 2);
+    EXPECT_EQ(db.count(42, 0), 1);
+    EXPECT_EQ(db.count(42, 1), 0);
+
+    for (std::uint32_t i = 0; i < db.size(); i++) {
+        PuzzleDatabase::entry entry;
+        ASSERT_TRUE(db.get(i, entry));
+        EXPECT_EQ(entry.empty, 40 + (int)i);
+        EXPECT_EQ(entry.hash, PuzzleDatabase::canonicalHash(entry.puzzle));
+        Sudoku::puzzle solved = entry.puzzle;
+        ASSERT_TRUE(Sudoku::solve(solved));
+        EXPECT_EQ(solved, entry.solution);
+    }
+}
+
+TEST(DatabaseTest, random) {
+    std::string fileName = tempDatabase("tuidoku_random.db");
+    PuzzleDatabase db(fileName);
+    fill(db, 6);
+    PuzzleDatabase::entry entry;
+    for (auto i = 0; i < 10; i++) {
+        ASSERT_TRUE(db.random(PuzzleDatabase::ANY, 2, entry));
+        EXPECT_EQ(entry.tier, 2);
+        EXPECT_EQ(entry.empty % 3, 2);
+        ASSERT_TRUE(db.random(43, PuzzleDatabase::ANY, entry));
+        EXPECT_EQ(entry.empty, 43);
+    }
+    EXPECT_FALSE(db.random(60, PuzzleDatabase::ANY, entry));
+    EXPECT_FALSE(db.random(PuzzleDatabase::ANY, 5, entry));
+}
+
+TEST(DatabaseTest, rejectsEquivalentPuzzles) {
+    std::string fileName = tempDatabase("tuidoku_equivalent.db");
+    PuzzleDatabase db(fileName);
+    Sudoku::puzzle puzzle = Sudoku::generate(45);
+    Sudoku::puzzle solution = puzzle;
+    Sudoku::solve(solution);
+    ASSERT_TRUE(db.append(puzzle, solution, 1));
+
+    // Rotated a quarter turn with every digit replaced by the next one
+    Sudoku::puzzle rotated;
+    Sudoku::puzzle rotatedSolution;
+    for (auto i = 0; i < Sudoku::SIZE; i++) {
+        for (auto j = 0; j < Sudoku::SIZE; j++) {
+            int val = puzzle[Sudoku::SIZE - 1 - j][i];
+            rotated[i][j] = val == 0 ? 0 : val % Sudoku::SIZE + 1;
+            rotatedSolution[i][j] = solution[Sudoku::SIZE - 1 - j][i] % Sudoku::SIZE + 1;
+        }
+    }
+    EXPECT_EQ(PuzzleDatabase::canonicalHash(rotated), PuzzleDatabase::canonicalHash(puzzle));
+    EXPECT_FALSE(db.append(rotated, rotatedSolution, 1));
+    EXPECT_EQ(db.size(), 1);
+
+    PuzzleDatabase::entry entry;
+    ASSERT_TRUE(db.find(PuzzleDatabase::canonicalHash(rotated), entry));
+    EXPECT_EQ(entry.puzzle, puzzle);
+}
+
+TEST(DatabaseTest, rebuildsIndex) {
+    std::string fileName = tempDatabase("tuidoku_rebuild.db");
+    {
+        PuzzleDatabase db(fileName);
+        fill(db, 4);
+    }
+    std::remove((fileName + ".idx").c_str());
+    {
+        PuzzleDatabase db(fileName);
+        ASSERT_TRUE(db.isValid());
+        EXPECT_EQ(db.size(), 4);
+        EXPECT_EQ(db.count(41, 2), 1);
+    }
+    PuzzleDatabase db(fileName);
+    EXPECT_EQ(db.size(), 4);
+}
+
+/**
+ * @brief An index entry that doesn't fit the buckets makes the index stale
+ *
+ */
+TEST(DatabaseTest, rebuildsCorruptIndex) {
+    std::string fileName = tempDatabase("tuidoku_corrupt.db");
+    {
+        PuzzleDatabase db(fileName);
+        fill(db, 4);
+    }
+    for (auto offset : {12, 13}) {
+        // empty cells and tier of the second entry, past the magic
+        std::FILE *file = std::fopen((fileName + ".idx").c_str(), "r+b");
+        std::fseek(file, 8 + 16 + offset, SEEK_SET);
+        std::fputc(0xFF, file);
+        std::fclose(file);
+
+        PuzzleDatabase db(fileName);
+        ASSERT_TRUE(db.isValid());
+        EXPECT_EQ(db.size(), 4);
+        EXPECT_EQ(db.count(41, 2), 1);
+        EXPECT_EQ(db.count(PuzzleDatabase::ANY, PuzzleDatabase::ANY), 4);
+    }
+}
+
+/**
+ * @brief Index entries for records cut off the data file make the index stale
+ *
+ * So does half an entry at the end of the index, appending after it would
+ * put every later entry out of place.
+ */
+TEST(DatabaseTest, rebuildsLongerIndex) {
+    std::string fileName = tempDatabase("tuidoku_truncated.db");
+    {
+        PuzzleDatabase db(fileName);
+        fill(db, 4);
+    }
+    // back to the end of the second record, the header is 8 bytes
+    std::uintmax_t size = std::filesystem::file_size(fileName);
+    std::filesystem::resize_file(fileName, 8 + (size - 8) / 2);
+    {
+        PuzzleDatabase db(fileName);
+        ASSERT_TRUE(db.isValid());
+        EXPECT_EQ(db.size(), 2);
+        EXPECT_EQ(db.count(PuzzleDatabase::ANY, PuzzleDatabase::ANY), 2);
+        EXPECT_EQ(db.count(42, 0), 0);
+        EXPECT_EQ(std::filesystem::file_size(fileName + ".idx"), 8 + 2 * 16);
+        fill(db, 3);
+        EXPECT_EQ(db.size(), 5);
+    }
+    std::filesystem::resize_file(fileName + ".idx", std::filesystem::file_size(fileName + ".idx") - 1);
+    PuzzleDatabase db(fileName);
+    ASSERT_TRUE(db.isValid());
+    EXPECT_EQ(db.size(), 5);
+    EXPECT_EQ(db.count(42, 0), 1);
+    EXPECT_EQ(std::filesystem::file_size(fileName + ".idx"), 8 + 5 * 16);
+}
+
+TEST(DatabaseTest, notADatabase) {
+    std::string fileName = tempDatabase("tuidoku_invalid.db");
+    {
+        std::FILE *file = std::fopen(fileName.c_str(), "w");
+        std::fputs("..3.2.6..9..3.5..1..18.64....81.29..7.......8..67.82....26.95..8..2.3..9..5.1.3..\n", file);
+        std::fclose(file);
+    }
+    PuzzleDatabase db(fileName);
+    EXPECT_FALSE(db.isValid());
+    Sudoku::puzzle puzzle = {};
+    EXPECT_FALSE(db.append(puzzle, puzzle, 0));
+}
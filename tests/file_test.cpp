@@ -132,3 +132,26 @@ TEST_F(FileTest, getSSPuzzle) {
     this->runTests(test_table, sizeof(test_table) / sizeof(test_table[0]));
 }
 
+/**
+ * @brief Unit test for getMask which parses clue positions
+ * 
+ */
+TEST(FileMaskTest, getMask) {
+    std::stringstream maskStream("# comment\n.X.X.X.X...XX.XX..X.......XX..X.X..X..X...X..X..X.X..XX.......X..XX.XX...X.X.X.X.\n");
+    Sudoku::mask mask;
+    ASSERT_TRUE(file::getMask(maskStream, mask));
+    EXPECT_EQ(Sudoku::countClues(mask), 30);
+    EXPECT_FALSE(mask[0][0]);
+    EXPECT_TRUE(mask[0][1]);
+    EXPECT_TRUE(mask[8][7]);
+    EXPECT_FALSE(mask[8][8]);
+
+    Sudoku::mask fromString;
+    ASSERT_TRUE(file::getMask("..X..............................................................................", fromString));
+    EXPECT_EQ(Sudoku::countClues(fromString), 1);
+    EXPECT_TRUE(fromString[0][2]);
+
+    // a square short or a square too many isn't a mask
+    EXPECT_FALSE(file::getMask("..X.............................................................................", fromString));
+    EXPECT_FALSE(file::getMask("..X...............................................................................", fromString));
+}
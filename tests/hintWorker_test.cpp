@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "../src/HintWorker.h"
+
+static void expectSameHint(const Hint &hint, const Hint &expected) {
+    ASSERT_EQ(hint.difficulty, expected.difficulty);
+    ASSERT_EQ(hint.moves.size(), expected.moves.size());
+    for (size_t i = 0; i < hint.moves.size(); i++) {
+        EXPECT_EQ(hint.moves[i].val, expected.moves[i].val);
+        EXPECT_EQ(hint.moves[i].row, expected.moves[i].row);
+        EXPECT_EQ(hint.moves[i].col, expected.moves[i].col);
+        EXPECT_EQ(hint.moves[i].move, expected.moves[i].move);
+    }
+}
+
+/**
+ * @brief The worker has to give the hint for the board as it is now
+ *
+ * The board is changed between hints, also by the player making moves
+ * that are not hints, and the worker is handed boards it never gets to
+ * finish.
+ */
+TEST(HintWorker_test, followsBoard) {
+    Board board("200150074001000020407600013040200095070480060010000430706000289004907350003000040");
+    board.autoPencil();
+    HintWorker worker(board);
+
+    Board copy = board;
+    expectSameHint(worker.get(board), solveHuman(copy));
+
+    board.pencil('9', 0, 1);
+    worker.update(board);
+    board.insert('3', 0, 2);
+    worker.update(board);
+    board.insert(ERASE_KEY, 0, 2);
+    copy = board;
+    expectSameHint(worker.get(board), solveHuman(copy));
+
+    board.autoPencil();
+    Hint hint = worker.get(board);
+    while (hint.moves.size() > 0) {
+        copy = board;
+        expectSameHint(hint, solveHuman(copy));
+        for (auto &move : hint.moves) {
+            move(&board);
+        }
+        worker.update(board);
+        hint = worker.get(board);
+    }
+    EXPECT_EQ(board.getPlayGrid(), board.getSolution());
+}
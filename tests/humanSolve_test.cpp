@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include "humanSolve_test.h"
+#include "../src/Journal.h"
+#include "../src/Zobrist.h"
+#include <algorithm>
+#include <vector>
 
 /**
  * @brief Unit test for findNakedSingle
@@ -57,7 +61,7 @@ TEST(HumanSolve_test, findXwing) {
     };
 
     for (auto &test : test_table) {
-        std::vector<Move> moves;
+        MoveList moves;
         Board board(test.gridString);
         board.autoPencil();
 
@@ -74,13 +78,70 @@ TEST(HumanSolve_test, findXwing) {
     }
 }
 
+/**
+ * @brief Unit test for findFish, X-wings are covered by findXwing
+ * 
+ */
+TEST(HumanSolve_test, findFish) {
+    struct {
+        int size;
+        single_digit_human_solve_t test;
+    } test_table[] = {
+        {2, {(1 << 0), {0, 0, 0, NULL}, 0, false, "805204930902030500603975028750300269328009075096752803287193654060507302530026701"}},
+        {3, {(1 << 0), {'1', 1, 1, &Board::pencil}, 2, true, "805204930902030500603975028750300269328009075096752803287193654060507302530026701"}},
+        {3, {(1 << 4), {0, 0, 0, NULL}, 0, false, "805204930902030500603975028750300269328009075096752803287193654060507302530026701"}},
+    };
+
+    for (auto &fish : test_table) {
+        auto &test = fish.test;
+        MoveList moves;
+        Board board(test.gridString);
+        board.autoPencil();
+
+        std::stringstream boardstrstream;
+        board.printBoard(boardstrstream);
+        EXPECT_EQ(findFish(board, test.num, fish.size, moves), test.ret) << "Could not find fish of size " << fish.size << ":\n" << boardstrstream.str();
+        ASSERT_EQ(moves.size(), test.moves);
+        if (test.ret == false) continue;
+
+        EXPECT_EQ(moves[0].val, test.move.val);
+        EXPECT_EQ(moves[0].row, test.move.row);
+        EXPECT_EQ(moves[0].col, test.move.col);
+        EXPECT_EQ(moves[0].move, test.move.move);
+    }
+}
+
+/**
+ * @brief Grades stored before swordfish and jellyfish keep their meaning
+ *
+ * The first board needs a swordfish next, the other one is beyond every
+ * technique.
+ */
+TEST(HumanSolve_test, fishDifficulty) {
+    Board fish("805204930902030500603975028750300269328009075096752803287193654060507302530026701");
+    fish.autoPencil();
+    Hint hint = solveHuman(fish);
+    EXPECT_EQ(hint.difficulty, 16);
+    EXPECT_EQ(hint.hint1(), "Look for a swordfish");
+
+    Board stuck("800000000003600000070090200050007000000045700000100030001000068008500010090000400");
+    stuck.autoPencil();
+    Grade grade = gradeHuman(stuck);
+    EXPECT_FALSE(grade.solved);
+    EXPECT_EQ(grade.difficulty, 15);
+    hint = solveHuman(stuck);
+    EXPECT_EQ(hint.difficulty, UNSOLVED_DIFFICULTY);
+    EXPECT_EQ(hint.hint1(), "Unable to give any hints");
+    EXPECT_EQ(hint.hint2(), "This is out of my league");
+}
+
 TEST(HumanSolve_test, findUniqueRectangle) {
     single_digit_human_solve_t test_table[] = {
         {((1 << 7) | (1 << 8)), {'8', 1, 1, &Board::pencil}, 2, true, "502008967100700452067500381213657849654891273700004615821900034306000098005083026"},
     };
 
     for (auto &test : test_table) {
-        std::vector<Move> moves;
+        MoveList moves;
         Board board(test.gridString);
         board.autoPencil();
 
@@ -103,7 +164,7 @@ TEST(HumanSolve_test, findChainOfPairs) {
     };
 
     for (auto &test : test_table) {
-        std::vector<Move> moves;
+        MoveList moves;
         Board board(test.gridString);
         board.autoPencil();
 
@@ -119,3 +180,403 @@ TEST(HumanSolve_test, findChainOfPairs) {
         EXPECT_EQ(moves[0].move, test.move.move);
     }
 }
+
+/**
+ * @brief Rebuilds the position table of a board from its pencil marks
+ */
+static std::array<std::array<std::uint16_t, 9>, 27> buildPositions(const Board &board) {
+    std::array<std::array<std::uint16_t, 9>, 27> positions = {};
+    for (auto i = 0; i < 9; i++) {
+        for (auto j = 0; j < 9; j++) {
+            if (!board.isEmpty(i, j)) continue;
+            for (auto num = 0; num < 9; num++) {
+                if ((board.getPencil(i, j) & (1 << num)) == 0) continue;
+                positions[Board::ROW_UNIT + i][num] |= (1 << j);
+                positions[Board::COL_UNIT + j][num] |= (1 << i);
+                positions[Board::BOX_UNIT + (i / 3) * 3 + j / 3][num] |= (1 << ((i % 3) * 3 + j % 3));
+            }
+        }
+    }
+    return positions;
+}
+
+/**
+ * @brief The position table has to follow every insert, erase and pencil mark
+ * 
+ */
+TEST(HumanSolve_test, positionTable) {
+    Board board("980062753065003000327050006790030500050009000832045009673591428249087005518020007");
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+    board.autoPencil();
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+
+    board.insert('4', 0, 2);
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+    board.insert(ERASE_KEY, 0, 2);
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+    board.pencil('1', 1, 3);
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+    board.pencil(ERASE_KEY, 1, 0);
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+
+    board.autoPencil();
+    Hint hint = solveHuman(board);
+    while (hint.moves.size() > 0) {
+        for (auto &move : hint.moves) {
+            move(&board);
+            ASSERT_EQ(board.getPositions(), buildPositions(board));
+        }
+        hint = solveHuman(board);
+    }
+    EXPECT_EQ(board.getPlayGrid(), board.getSolution());
+}
+
+/**
+ * @brief Erasing a digit has to put back the pencil marks it removed
+ * 
+ */
+TEST(HumanSolve_test, restoreMarks) {
+    Board board("980062753065003000327050006790030500050009000832045009673591428249087005518020007");
+    board.autoPencil();
+    auto marks = board.getPencilMarks();
+
+    board.insert('4', 0, 2);
+    EXPECT_NE(board.getPencilMarks(), marks);
+    board.insert(ERASE_KEY, 0, 2);
+    EXPECT_EQ(board.getPencilMarks(), marks);
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+
+    // Overwriting restores the marks of the old digit first
+    board.insert('4', 0, 2);
+    board.insert('1', 0, 2);
+    board.insert(ERASE_KEY, 0, 2);
+    EXPECT_EQ(board.getPencilMarks(), marks);
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+
+    // A peer filled with the digit in the meantime keeps its marks away
+    board.insert('4', 0, 2);
+    board.insert('4', 1, 0);
+    board.insert(ERASE_KEY, 0, 2);
+    EXPECT_EQ(board.getPencil(0, 2) & (1 << 3), 0);
+    EXPECT_EQ(board.getPencil(4, 2) & (1 << 3), 1 << 3);
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+}
+
+/**
+ * @brief Hashes a board from scratch
+ */
+static std::uint64_t buildHash(const Board &board, bool marks) {
+    std::uint64_t hash = 0;
+    for (auto cell = 0; cell < Sudoku::CELLS; cell++) {
+        int row = Sudoku::ROW_OF[cell];
+        int col = Sudoku::COL_OF[cell];
+        int val = board.getPlayGrid()[row][col];
+        if (val != 0) {
+            hash ^= Zobrist::DIGITS[cell][val - 1];
+            continue;
+        }
+        for (auto digit = 0; digit < 9 && marks; digit++) {
+            if (board.getPencil(row, col) & (1 << digit)) hash ^= Zobrist::MARKS[cell][digit];
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief The hashes have to follow every change and come back with the position
+ * 
+ */
+TEST(HumanSolve_test, boardHash) {
+    Board board("980062753065003000327050006790030500050009000832045009673591428249087005518020007");
+    Journal journal;
+    auto check = [&board]() {
+        ASSERT_EQ(board.getHash(), buildHash(board, true));
+        ASSERT_EQ(board.getGridHash(), buildHash(board, false));
+    };
+    check();
+    std::uint64_t start = board.getHash();
+    journal.autoPencil(board);
+    check();
+    std::uint64_t pencilled = board.getHash();
+    EXPECT_NE(pencilled, start);
+
+    journal.insert(board, '4', 0, 2);
+    check();
+    std::uint64_t inserted = board.getHash();
+    journal.pencil(board, '1', 1, 3);
+    check();
+    journal.insert(board, ERASE_KEY, 0, 2);
+    check();
+    journal.pencil(board, '1', 1, 3);
+    check();
+    EXPECT_EQ(board.getHash(), pencilled);
+    journal.insert(board, '4', 0, 2);
+    EXPECT_EQ(board.getHash(), inserted);
+
+    while (journal.undo(board)) {
+        check();
+    }
+    EXPECT_EQ(board.getHash(), start);
+    board.autoPencil();
+    Hint hint = solveHuman(board);
+    while (hint.moves.size() > 0) {
+        for (auto &move : hint.moves) {
+            move(&board);
+        }
+        check();
+        hint = solveHuman(board);
+    }
+}
+
+/**
+ * @brief Assigning a grid has to leave the board as inserting every digit does
+ * 
+ */
+TEST(HumanSolve_test, assign) {
+    Board board("980062753065003000327050006790030500050009000832045009673591428249087005518020007");
+    board.autoPencil();
+    Board inserted = board;
+
+    // every other square of the solution, clues have to be kept
+    Sudoku::puzzle grid = board.getSolution();
+    for (auto row = 0; row < 9; row++) {
+        for (auto col = 0; col < 9; col++) {
+            if (board.getStartGrid()[row][col] != 0) {
+                grid[row][col] = 0;
+            }
+            else if ((row + col) % 2) {
+                grid[row][col] = 0;
+            }
+            else {
+                inserted.insert(grid[row][col] + START_CHAR - 1, row, col);
+            }
+        }
+    }
+    board.assign(grid);
+    EXPECT_EQ(board.getPlayGrid(), inserted.getPlayGrid());
+    EXPECT_EQ(board.getPositions(), inserted.getPositions());
+    EXPECT_EQ(board.getHash(), inserted.getHash());
+    EXPECT_EQ(board.getHash(), buildHash(board, true));
+    EXPECT_EQ(board.getGridHash(), buildHash(board, false));
+    EXPECT_EQ(board.getFilled(), inserted.getFilled());
+    EXPECT_EQ(board.getPencilMarks(), inserted.getPencilMarks());
+
+    board.assign(board.getSolution());
+    EXPECT_EQ(board.getPositions(), buildPositions(board));
+    for (auto row = 0; row < 9; row++) {
+        for (auto col = 0; col < 9; col++) {
+            EXPECT_EQ(board.getPencil(row, col), 0);
+        }
+    }
+    EXPECT_TRUE(board.isWon());
+}
+
+/**
+ * @brief Auto pencil has to mark every digit no peer has
+ * 
+ */
+TEST(HumanSolve_test, autoPencil) {
+    Board board("980062753065003000327050006790030500050009000832045009673591428249087005518020007");
+    auto check = [&board]() {
+        board.autoPencil();
+        const auto &grid = board.getPlayGrid();
+        for (auto row = 0; row < 9; row++) {
+            for (auto col = 0; col < 9; col++) {
+                if (grid[row][col] != 0) continue;
+                std::uint16_t marks = 0;
+                for (auto digit = 1; digit <= 9; digit++) {
+                    if (Sudoku::isSafe(grid, row, col, digit)) marks |= 1 << (digit - 1);
+                }
+                ASSERT_EQ(board.getPencil(row, col), marks);
+            }
+        }
+        ASSERT_EQ(board.getPositions(), buildPositions(board));
+    };
+    check();
+    board.insert('4', 0, 2);
+    check();
+    // a conflicting digit takes the marks of both squares' peers
+    board.insert('4', 1, 0);
+    check();
+    board.insert(ERASE_KEY, 0, 2);
+    check();
+}
+
+/**
+ * @brief Conflicts, safe digits and the win have to follow every change
+ * 
+ */
+TEST(HumanSolve_test, squareCounts) {
+    Board board("980062753065003000327050006790030500050009000832045009673591428249087005518020007");
+    auto check = [&board]() {
+        const auto &grid = board.getPlayGrid();
+        int filled = 0;
+        for (auto row = 0; row < 9; row++) {
+            for (auto col = 0; col < 9; col++) {
+                filled += grid[row][col] != 0;
+                auto copy = grid;
+                copy[row][col] = 0;
+                bool conflict = grid[row][col] != 0 && !Sudoku::isSafe(copy, row, col, grid[row][col]);
+                ASSERT_EQ(board.isConflict(row, col), conflict);
+                ASSERT_EQ(board.isCorrect(row, col), grid[row][col] == board.getSolution()[row][col]);
+                for (auto digit = 1; digit <= 9; digit++) {
+                    ASSERT_EQ(board.isSafe(digit, row, col), Sudoku::isSafe(grid, row, col, digit));
+                }
+            }
+        }
+        ASSERT_EQ(board.getFilled(), filled);
+    };
+    check();
+
+    board.insert('9', 0, 2);
+    check();
+    board.insert('4', 0, 2);
+    check();
+    board.insert('8', 1, 0);
+    check();
+    board.insert('8', 1, 8);
+    check();
+    board.insert(ERASE_KEY, 1, 0);
+    check();
+    board.insert(ERASE_KEY, 1, 8);
+    check();
+    EXPECT_FALSE(board.isWon());
+
+    const auto &solution = board.getSolution();
+    for (auto row = 0; row < 9; row++) {
+        for (auto col = 0; col < 9; col++) {
+            board.insert(solution[row][col] + START_CHAR - 1, row, col);
+        }
+    }
+    check();
+    EXPECT_TRUE(board.isComplete());
+    EXPECT_TRUE(board.isWon());
+    board.insert(ERASE_KEY, 0, 2);
+    EXPECT_FALSE(board.isComplete());
+    EXPECT_FALSE(board.isWon());
+
+    // full again, but with the digit of the next square twice in the row
+    board.insert(solution[0][2] % 9 + START_CHAR, 0, 2);
+    check();
+    EXPECT_FALSE(board.isComplete());
+}
+
+/**
+ * @brief A solver kept between hints has to give the same hints as a new one
+ * 
+ */
+TEST(HumanSolve_test, solverSession) {
+    const char *grids[] = {
+        "009032000000700000162000000010020560000900000050000107000000403026009000005870000",
+        "200150074001000020407600013040200095070480060010000430706000289004907350003000040",
+        "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+    };
+    for (auto grid : grids) {
+        Board board(grid);
+        board.autoPencil();
+        HumanSolver solver(board);
+        Hint hint = solver.nextHint();
+        while (true) {
+            Board copy = board;
+            Hint expected = solveHuman(copy);
+            ASSERT_EQ(hint.difficulty, expected.difficulty);
+            ASSERT_EQ(hint.hint1(), expected.hint1());
+            ASSERT_EQ(hint.hint2(), expected.hint2());
+            ASSERT_EQ(hint.moves.size(), expected.moves.size());
+            for (size_t i = 0; i < hint.moves.size(); i++) {
+                EXPECT_EQ(hint.moves[i].val, expected.moves[i].val);
+                EXPECT_EQ(hint.moves[i].row, expected.moves[i].row);
+                EXPECT_EQ(hint.moves[i].col, expected.moves[i].col);
+                EXPECT_EQ(hint.moves[i].move, expected.moves[i].move);
+            }
+            if (hint.moves.empty()) break;
+            for (auto &move : hint.moves) {
+                move(&board);
+            }
+            hint = solver.nextHint();
+        }
+    }
+}
+
+/**
+ * @brief The subset search has to find what trying every combination finds
+ * 
+ */
+TEST(HumanSolve_test, findSubset) {
+    const char *grids[] = {
+        "009032000000700000162000000010020560000900000050000107000000403026009000005870000",
+        "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+        "000204930000000500603970020050300260008000070090050800087093004000507302000006000",
+    };
+    std::vector<std::uint16_t> all[10];
+    for (std::uint16_t bits = 1; bits < (1 << 9); bits++) {
+        all[__builtin_popcount(bits)].push_back(bits);
+    }
+    for (auto grid : grids) {
+        Board board(grid);
+        board.autoPencil();
+        Hint hint = solveHuman(board);
+        while (hint.moves.size() > 0) {
+            for (auto size = 2; size <= 4; size++) {
+                for (int naked = 0; naked < 2; naked++) {
+                    MoveList expected;
+                    // the combinations in order, smallest digits first
+                    std::vector<std::uint16_t> ordered = all[size];
+                    std::sort(ordered.begin(), ordered.end(), [](std::uint16_t a, std::uint16_t b) {
+                        for (; a != 0 && b != 0; a &= a - 1, b &= b - 1) {
+                            if (__builtin_ctz(a) != __builtin_ctz(b)) return __builtin_ctz(a) < __builtin_ctz(b);
+                        }
+                        return false;
+                    });
+                    for (auto digits : ordered) {
+                        if (naked ? findNaked(board, digits, expected) : findHidden(board, digits, expected)) break;
+                    }
+                    MoveList moves;
+                    bool ret = naked ? findNakedSubset(board, size, moves) : findHiddenSubset(board, size, moves);
+                    EXPECT_EQ(ret, !expected.empty());
+                    ASSERT_EQ(moves.size(), expected.size());
+                    for (size_t i = 0; i < moves.size(); i++) {
+                        EXPECT_EQ(moves[i].val, expected[i].val);
+                        EXPECT_EQ(moves[i].row, expected[i].row);
+                        EXPECT_EQ(moves[i].col, expected[i].col);
+                    }
+                }
+            }
+            for (auto &move : hint.moves) {
+                move(&board);
+            }
+            hint = solveHuman(board);
+        }
+    }
+}
+
+/**
+ * @brief Placing all singles at once has to make the same moves
+ * 
+ * Only puzzles that need nothing but singles can get a different grade,
+ * 1 instead of 2 when naked singles are enough.
+ */
+TEST(HumanSolve_test, gradeAllSingles) {
+    const char *grids[] = {
+        "009032000000700000162000000010020560000900000050000107000000403026009000005870000",
+        "200150074001000020407600013040200095070480060010000430706000289004907350003000040",
+        "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+        "000204930000000500603970020050300260008000070090050800087093004000507302000006000",
+    };
+    for (auto grid : grids) {
+        Board board(grid);
+        board.autoPencil();
+        Board batch = board;
+        Grade expected = gradeHuman(board);
+        Grade grade = gradeHuman(batch, true);
+        EXPECT_EQ(grade.moves, expected.moves);
+        EXPECT_EQ(grade.solved, expected.solved);
+        EXPECT_EQ(batch.getPlayGrid(), board.getPlayGrid());
+        if (expected.difficulty > 2) {
+            EXPECT_EQ(grade.difficulty, expected.difficulty);
+        }
+        else {
+            EXPECT_LE(grade.difficulty, expected.difficulty);
+        }
+    }
+}
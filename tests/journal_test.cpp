@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "../src/Journal.h"
+#include <vector>
+
+struct state {
+    Sudoku::puzzle grid;
+    Board::markTable marks;
+    std::array<std::array<std::uint16_t, 9>, 27> positions;
+    bool operator==(const state &r) const {
+        return grid == r.grid && marks == r.marks && positions == r.positions;
+    }
+};
+
+static state getState(Board &board) {
+    return {board.getPlayGrid(), board.getPencilMarks(), board.getPositions()};
+}
+
+/**
+ * @brief Undo has to go back through every state and redo forward again
+ *
+ */
+TEST(Journal_test, undoRedo) {
+    Board board("200150074001000020407600013040200095070480060010000430706000289004907350003000040");
+    Journal journal;
+    std::vector<state> states = {getState(board)};
+
+    journal.autoPencil(board);
+    states.push_back(getState(board));
+    journal.pencil(board, '9', 0, 1);
+    states.push_back(getState(board));
+    journal.insert(board, '3', 0, 2);
+    states.push_back(getState(board));
+    journal.insert(board, '6', 0, 2);
+    states.push_back(getState(board));
+    journal.insert(board, ERASE_KEY, 0, 2);
+    states.push_back(getState(board));
+    for (auto i = 0; i < 5; i++) {
+        Hint hint = solveHuman(board);
+        journal.apply(board, hint);
+        states.push_back(getState(board));
+    }
+
+    // Inserting into a clue changes nothing and isn't a step
+    journal.insert(board, '5', 0, 0);
+
+    for (auto i = states.size() - 1; i > 0; i--) {
+        ASSERT_TRUE(journal.undo(board));
+        ASSERT_EQ(getState(board), states[i - 1]);
+    }
+    EXPECT_FALSE(journal.undo(board));
+
+    for (auto i = 1u; i < states.size(); i++) {
+        ASSERT_TRUE(journal.redo(board));
+        ASSERT_EQ(getState(board), states[i]);
+    }
+    EXPECT_FALSE(journal.redo(board));
+
+    // A new change throws away what could be redone
+    journal.undo(board);
+    journal.undo(board);
+    journal.pencil(board, '1', 8, 8);
+    EXPECT_FALSE(journal.redo(board));
+    journal.undo(board);
+    EXPECT_EQ(getState(board), states[states.size() - 3]);
+}
+
+/**
+ * @brief A full journal drops whole steps from the start
+ *
+ */
+TEST(Journal_test, full) {
+    Board board("200150074001000020407600013040200095070480060010000430706000289004907350003000040");
+    Journal journal;
+    std::vector<state> states = {getState(board)};
+    journal.autoPencil(board);
+    states.push_back(getState(board));
+    for (auto i = 0u; i < Journal::CAPACITY; i++) {
+        journal.pencil(board, ERASE_KEY, 0, 1);
+        states.push_back(getState(board));
+        journal.pencil(board, ERASE_KEY, 0, 2);
+        states.push_back(getState(board));
+        journal.autoPencil(board);
+        states.push_back(getState(board));
+    }
+
+    auto i = states.size() - 1;
+    while (journal.undo(board)) {
+        ASSERT_GT(i, 0u);
+        ASSERT_EQ(getState(board), states[--i]);
+    }
+    EXPECT_GT(i, 0u);
+}
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include "../src/LruCache.h"
+
+/**
+ * @brief A full cache has to replace the value used longest ago
+ *
+ */
+TEST(LruCache_test, replacesOldest) {
+    LruCache<int, 3> cache;
+    int value = 0;
+    EXPECT_FALSE(cache.get(1, value));
+
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_TRUE(cache.get(1, value));
+    EXPECT_EQ(value, 10);
+
+    // 2 is the oldest now that 1 was used
+    cache.put(4, 40);
+    EXPECT_FALSE(cache.get(2, value));
+    EXPECT_TRUE(cache.get(3, value));
+    EXPECT_EQ(value, 30);
+
+    // putting a cached key replaces its value
+    cache.put(4, 41);
+    EXPECT_TRUE(cache.get(4, value));
+    EXPECT_EQ(value, 41);
+    EXPECT_EQ(cache.size(), 3u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_FALSE(cache.get(4, value));
+}